@@ -39,6 +39,9 @@ class Buffer(openwns.Buffer.Buffer):
     managerName = None
 
     drop = 'Tail'
+
+    lifetimeDropsProbeName = 'wifimac.buffer.lifetimeDrops'
+    """ Number of compounds dropped by one lifetime check, only checks with drops are probed """
     def __init__(self, protocolCalculatorName, raName, managerName, parentLogger = None, **kw):
         super(Buffer, self).__init__(**kw)
         self.raName = raName
@@ -44,6 +44,10 @@ class DCFConfig(object):
     """ maximum size of the contention window """
     backoffDisabled = False
     """ disable BO, usefull e.g. for the broadcast-BO in STAs """
+    contentionDomain = None
+    """ name of the channel, all backoffs with the same name share one timer
+        and the backoffs with the same channel state are frozen and resumed
+        together; None schedules an individual timer per backoff """
 
     def __init__(self, cwMin = 15, cwMax = 1023):
         self.cwMin = cwMin
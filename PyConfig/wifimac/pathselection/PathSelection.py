@@ -81,6 +81,19 @@ class VirtualPS(openwns.node.Component):
     nameInComponentFactory = "wifimac.pathselection.VirtualPathSelection"
     useStaticPS = False
     staticPSsnapshotTimeout = 0.0
+    # repair the path matrix after each link change instead of a full
+    # Floyd-Warshall recomputation
+    incrementalUpdate = False
+    # compare each incremental update with the full recomputation
+    verifyIncrementalUpdate = False
+    # relative deviation of a path cost up to which the incremental update
+    # matches the full recomputation
+    verifyTolerance = 1e-9
+    # link changes only invalidate the path matrix, it is computed once per
+    # simulation time step or on the next query
+    deferredUpdate = False
+    # number of threads for the full recomputation of the path matrix
+    numThreads = 1
     logger = None
     numNodes = None
     preKnowledge = None
@@ -27,6 +27,7 @@
 
 from Duration import Duration
 from FrameLength import FrameLength
+from ErrorProbability import ErrorProbability
 
 import wifimac.Logger
 
@@ -44,8 +45,9 @@ class Service(object):
 class Config:
     duration = None
     frameLength = None
+    errorProbability = None
 
-    def __init__(self, dur = None, fl = None):
+    def __init__(self, dur = None, fl = None, ep = None):
         if(dur is None):
             self.duration = Duration(fl)
         else:
@@ -56,6 +58,11 @@ class Config:
         else:
             self.frameLength = fl
 
+        if(ep is None):
+            self.errorProbability = ErrorProbability()
+        else:
+            self.errorProbability = ep
+
 class ProtocolCalculator(Service):
     logger  = None
     myConfig = None
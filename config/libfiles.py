@@ -53,6 +53,7 @@ srcFiles = [
 
     'src/lowerMAC/timing/DCF.cpp',
     'src/lowerMAC/timing/Backoff.cpp',
+    'src/lowerMAC/timing/ContentionCoordinator.cpp',
 
     'src/lowerMAC/rateAdaptationStrategies/Constant.cpp',
     'src/lowerMAC/rateAdaptationStrategies/SINR.cpp',
@@ -65,6 +66,7 @@ srcFiles = [
     'src/draftn/BlockUntilReply.cpp',
     'src/draftn/Aggregation.cpp',
     'src/draftn/BlockACK.cpp',
+    'src/draftn/BlockACKScoreboard.cpp',
     'src/draftn/TransmissionQueue.cpp',
     'src/draftn/ReceptionQueue.cpp',
     'src/draftn/RTSCTSwithFLA.cpp',
@@ -87,6 +89,7 @@ srcFiles = [
 
     # Pathselection
     'src/pathselection/VirtualPathSelection.cpp',
+    'src/pathselection/AllPairsShortestPath.cpp',
     'src/pathselection/MeshForwarding.cpp',
     'src/pathselection/StationForwarding.cpp',
     'src/pathselection/PathSelectionOverVPS.cpp',
@@ -101,6 +104,10 @@ srcFiles = [
 
     # Tests
     #####'src/lowerMAC/timing/tests/BackoffTest.cpp',
+    'src/lowerMAC/timing/tests/ContentionCoordinatorTest.cpp',
+    'src/draftn/tests/BlockACKScoreboardTest.cpp',
+    'src/management/protocolCalculatorPlugins/tests/ErrorProbabilityTest.cpp',
+    'src/pathselection/tests/AllPairsShortestPathTest.cpp',
 ]
 
 hppFiles = [
@@ -128,6 +135,7 @@ hppFiles = [
     'src/helper/ThroughputProbe.hpp',
     'src/helper/DestinationSortedWindowProbe.hpp',
     'src/helper/CholeskyDecomposition.hpp',
+    'src/helper/tests/Random.hpp',
     'src/helper/contextprovider/CommandInformation.hpp',
     'src/helper/contextprovider/CompoundSize.hpp',
     'src/draftn/Aggregation.hpp',
@@ -135,6 +143,8 @@ hppFiles = [
     'src/lowerMAC/Buffer.hpp',
     'src/draftn/BlockACK.hpp',
     'src/draftn/BlockACKCommand.hpp',
+    'src/draftn/BlockACKScoreboard.hpp',
+    'src/draftn/tests/BlockACKScoreboardTest.hpp',
     'src/draftn/TransmissionQueue.hpp',
     'src/draftn/ReceptionQueue.hpp',
     'src/draftn/IBlockACKObserver.hpp',
@@ -160,8 +170,10 @@ hppFiles = [
     'src/draftn/rateAdaptationStrategies/PERwithMIMO.hpp',
     'src/draftn/rateAdaptationStrategies/ARFwithMIMO.hpp',
     'src/lowerMAC/timing/Backoff.hpp',
+    'src/lowerMAC/timing/ContentionCoordinator.hpp',
     'src/lowerMAC/timing/DCF.hpp',
     'src/lowerMAC/timing/tests/BackoffTest.hpp',
+    'src/lowerMAC/timing/tests/ContentionCoordinatorTest.hpp',
     'src/management/Beacon.hpp',
     'src/management/ILinkNotification.hpp',
     'src/management/PERInformationBase.hpp',
@@ -172,6 +184,8 @@ hppFiles = [
     'src/management/protocolCalculatorPlugins/FrameLength.hpp',
     'src/management/protocolCalculatorPlugins/Duration.hpp',
     'src/management/protocolCalculatorPlugins/ConfigGetter.hpp',
+    'src/management/protocolCalculatorPlugins/tests/ErrorProbabilityTest.hpp',
+    'src/pathselection/AllPairsShortestPath.hpp',
     'src/pathselection/BeaconLinkQualityMeasurement.hpp',
     'src/pathselection/ForwardingCommand.hpp',
     'src/pathselection/IPathSelection.hpp',
@@ -180,7 +194,8 @@ hppFiles = [
     'src/pathselection/Metric.hpp',
     'src/pathselection/PathSelectionOverVPS.hpp',
     'src/pathselection/StationForwarding.hpp',
-    'src/pathselection/VirtualPathSelection.hpp'
+    'src/pathselection/VirtualPathSelection.hpp',
+    'src/pathselection/tests/AllPairsShortestPathTest.hpp'
 ]
 
 pyconfigs = [
@@ -240,8 +255,9 @@ pyconfigs = [
     'wifimac/protocolCalculator/__init__.py',
     'wifimac/protocolCalculator/Duration.py',
     'wifimac/protocolCalculator/FrameLength.py',
+    'wifimac/protocolCalculator/ErrorProbability.py',
 ]
-dependencies = []
+dependencies = ['boost_thread']
 Return('libname srcFiles hppFiles pyconfigs dependencies')
 
 
@@ -66,6 +66,7 @@ ChannelState::ChannelState(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& c
     managerName(config.get<std::string>("managerName")),
     phyUserCommandName(config.get<std::string>("phyUserCommandName")),
     rtsctsCommandName(config.get<std::string>("rtsctsCommandName")),
+    rtsctsReader(NULL),
     txStartEndName(config.get<std::string>("txStartEndName")),
     rxStartEndName(config.get<std::string>("rxStartEndName")),
 
@@ -126,6 +127,7 @@ void ChannelState::onFUNCreated()
     MESSAGE_SINGLE(NORMAL, this->logger, "onFUNCreated() started");
 
     friends.manager = getFUN()->findFriend<wifimac::lowerMAC::Manager*>(managerName);
+    rtsctsReader = getFUN()->getCommandReader(rtsctsCommandName);
 
     // Observe txStartEnd
     if(activeIndicators.ownTx)
@@ -288,8 +290,8 @@ ChannelState::processIncoming(const wns::ldk::CompoundPtr& compound)
 
 bool ChannelState::isRTS(const wns::ldk::CompoundPtr& compound) const
 {
-    return((getFUN()->getCommandReader(rtsctsCommandName)->commandIsActivated(compound->getCommandPool())) and
-           (getFUN()->getCommandReader(rtsctsCommandName)->readCommand<wifimac::lowerMAC::RTSProviderCommand>(compound->getCommandPool())->isRTS()));
+    return((rtsctsReader->commandIsActivated(compound->getCommandPool())) and
+           (rtsctsReader->readCommand<wifimac::lowerMAC::RTSProviderCommand>(compound->getCommandPool())->isRTS()));
 }
 
 void ChannelState::onTimeout()
@@ -51,6 +51,7 @@
 #include <WNS/ldk/probe/Probe.hpp>
 #include <WNS/probe/bus/ContextCollector.hpp>
 #include <WNS/SlidingWindow.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace lowerMAC {
     class Manager;
@@ -213,6 +214,7 @@ namespace wifimac { namespace convergence {
         const std::string managerName;
         const std::string phyUserCommandName;
         const std::string rtsctsCommandName;
+        wns::ldk::CommandReaderInterface* rtsctsReader;
         const std::string txStartEndName;
         const std::string rxStartEndName;
 
@@ -46,24 +46,32 @@ ErrorModelling::ErrorModelling(wns::ldk::fun::FUN* fun, const wns::pyconfig::Vie
     config(_config),
     logger(config.get<wns::pyconfig::View>("logger")),
     phyUserCommandName(config.get<std::string>("phyUserCommandName")),
+    phyUserReader(NULL),
     managerCommandName(config.get<std::string>("managerCommandName")),
-    protocolCalculatorName(config.get<std::string>("protocolCalculatorName"))
+    managerReader(NULL),
+    protocolCalculatorName(config.get<std::string>("protocolCalculatorName")),
+    lastSINR(),
+    lastPhyMode(),
+    lastCodedError(0.0),
+    hasLastCodedError(false)
 {
 
 }
 
 void ErrorModelling::onFUNCreated()
 {
+    phyUserReader = getFUN()->getCommandReader(phyUserCommandName);
+    managerReader = getFUN()->getCommandReader(managerCommandName);
     pc = getFUN()->getLayer<dll::ILayer2*>()->getManagementService<wifimac::management::ProtocolCalculator>(protocolCalculatorName);
 }
 
 void ErrorModelling::processIncoming(const wns::ldk::CompoundPtr& compound)
 {
-    wns::Ratio sinr = getFUN()->getCommandReader(phyUserCommandName)->
+    wns::Ratio sinr = phyUserReader->
         readCommand<wifimac::convergence::CIRProviderCommand>(compound->getCommandPool())->getCIR();
-    wns::Power rss = getFUN()->getCommandReader(phyUserCommandName)->
+    wns::Power rss = phyUserReader->
         readCommand<wifimac::convergence::CIRProviderCommand>(compound->getCommandPool())->getRSS();
-    wifimac::convergence::PhyMode phyMode = getFUN()->getCommandReader(managerCommandName)->
+    wifimac::convergence::PhyMode phyMode = managerReader->
         readCommand<wifimac::lowerMAC::ManagerCommand>(compound->getCommandPool())->getPhyMode();
 
     ErrorModellingCommand* emc = activateCommand(compound->getCommandPool());
@@ -72,7 +80,19 @@ void ErrorModelling::processIncoming(const wns::ldk::CompoundPtr& compound)
     Bit dataSize = 0;
     this->calculateSizes(compound->getCommandPool(), commandPoolSize, dataSize);
 
-    emc->local.per = pc->getErrorProbability()->getPER(sinr, commandPoolSize + dataSize, phyMode);
+    // The subframes of an A-MPDU arrive one after another, usually with the
+    // same SINR and phyMode. Only the length-dependent part of the PER has to
+    // be computed for them.
+    if(not (hasLastCodedError and
+            sinr == lastSINR and
+            wifimac::management::protocolCalculatorPlugins::ErrorProbability::hasSameCodedError(phyMode, lastPhyMode)))
+    {
+        lastCodedError = pc->getErrorProbability()->getCodedError(sinr, phyMode);
+        lastSINR = sinr;
+        lastPhyMode = phyMode;
+        hasLastCodedError = true;
+    }
+    emc->local.per = pc->getErrorProbability()->getPERFromCodedError(lastCodedError, commandPoolSize + dataSize, phyMode);
 
     MESSAGE_BEGIN(NORMAL, logger, m, "New compound with SNR " << sinr);
     m << " len " << commandPoolSize + dataSize;
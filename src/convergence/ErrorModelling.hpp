@@ -38,6 +38,7 @@
 
 #include <WNS/pyconfig/View.hpp>
 #include <WNS/logger/Logger.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace convergence {
 
@@ -101,11 +102,20 @@ namespace wifimac { namespace convergence {
         wns::pyconfig::View config;
         wns::logger::Logger logger;
         const std::string phyUserCommandName;
+        wns::ldk::CommandReaderInterface* phyUserReader;
         const std::string managerCommandName;
+        wns::ldk::CommandReaderInterface* managerReader;
         const std::string protocolCalculatorName;
 
         wifimac::management::ProtocolCalculator* pc;
 
+        /** @brief SINR, phyMode and resulting coded error probability of the
+         * last received compound */
+        wns::Ratio lastSINR;
+        wifimac::convergence::PhyMode lastPhyMode;
+        double lastCodedError;
+        bool hasLastCodedError;
+
     }; // ErrorModelling
 } // convergence
 } // wifimac
@@ -73,9 +73,13 @@ FrameSynchronization::FrameSynchronization(wns::ldk::fun::FUN* fun, const wns::p
     lastFrameEnd(0),
     managerName(config.get<std::string>("managerName")),
     crcCommandName(config.get<std::string>("crcCommandName")),
+    crcReader(NULL),
     phyUserCommandName(config.get<std::string>("phyUserCommandName")),
+    phyUserReader(NULL),
     errorModellingCommandName(config.get<std::string>("errorModellingCommandName")),
+    errorModellingReader(NULL),
     txDurationProviderCommandName(config.get<std::string>("txDurationProviderCommandName")),
+    txDurationProviderReader(NULL),
     sinrMIBServiceName(config.get<std::string>("sinrMIBServiceName")),
     numSpatialStreamsLastPreambleFragment(0)
 {
@@ -150,11 +154,11 @@ void FrameSynchronization::processPreamble(const wns::ldk::CompoundPtr& compound
     assure(friends.manager->getFrameType(compound->getCommandPool()) == PREAMBLE,
            "called processPreamble for non-preamble");
 
-    bool crcOk = getFUN()->getCommandReader(crcCommandName)->readCommand<wns::ldk::crc::CRCCommand>(compound->getCommandPool())->local.checkOK;
+    bool crcOk = crcReader->readCommand<wns::ldk::crc::CRCCommand>(compound->getCommandPool())->local.checkOK;
 
     wns::simulator::Time fDur = friends.manager->getFrameExchangeDuration(compound->getCommandPool());
 
-    wns::Ratio sinr = getFUN()->getCommandReader(phyUserCommandName)->
+    wns::Ratio sinr = phyUserReader->
         readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool())->getCIR();
 
     if(sinr < detectionThreshold)
@@ -362,23 +366,23 @@ void FrameSynchronization::processPSDU(const wns::ldk::CompoundPtr& compound)
     MESSAGE_BEGIN(NORMAL, logger, m, "");
     m << "Received psdu. Synchronized: " << (curState == Synchronized or curState == waitForFinalDelivery);
     m << "; Transmitter ok: " << (friends.manager->getTransmitterAddress(compound->getCommandPool()) == this->synchronizedToAddress);
-    m << "; CRC ok: " << (getFUN()->getCommandReader(crcCommandName)->
+    m << "; CRC ok: " << (crcReader->
                           readCommand<wns::ldk::crc::CRCCommand>(compound->getCommandPool())->
                           local.checkOK);
     MESSAGE_END();
 
-    wns::Ratio sinr = getFUN()->getCommandReader(phyUserCommandName)->
+    wns::Ratio sinr = phyUserReader->
         readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool())->getCIRwithoutMIMO();
     sinrProbe->put(compound, sinr.get_dB());
 
-    double per = getFUN()->getCommandReader(errorModellingCommandName)->
+    double per = errorModellingReader->
         readCommand<wifimac::convergence::ErrorModellingCommand>(compound->getCommandPool())->getErrorRate();
     perProbe->put(compound, per);
 
     if((curState == Synchronized or curState == waitForFinalDelivery) and
        (friends.manager->getTransmitterAddress(compound->getCommandPool()) == this->synchronizedToAddress))
     {
-        if(getFUN()->getCommandReader(crcCommandName)->readCommand<wns::ldk::crc::CRCCommand>(compound->getCommandPool())->local.checkOK)
+        if(crcReader->readCommand<wns::ldk::crc::CRCCommand>(compound->getCommandPool())->local.checkOK)
         {
             MESSAGE_SINGLE(NORMAL, logger, "Received matching psdu for current synchronization");
             sinrMIB->putMeasurement(friends.manager->getTransmitterAddress(compound->getCommandPool()), sinr);
@@ -428,6 +432,10 @@ void FrameSynchronization::processPSDU(const wns::ldk::CompoundPtr& compound)
 
 void FrameSynchronization::onFUNCreated()
 {
+    crcReader = getFUN()->getCommandReader(crcCommandName);
+    phyUserReader = getFUN()->getCommandReader(phyUserCommandName);
+    errorModellingReader = getFUN()->getCommandReader(errorModellingCommandName);
+    txDurationProviderReader = getFUN()->getCommandReader(txDurationProviderCommandName);
     sinrMIB = getFUN()->getLayer<dll::ILayer2*>()->getManagementService<wifimac::management::SINRInformationBase>(sinrMIBServiceName);
     friends.manager = getFUN()->findFriend<wifimac::lowerMAC::Manager*>(managerName);
 
@@ -538,7 +546,7 @@ FrameSynchronization::traceIncoming(wns::ldk::CompoundPtr compound)
 
     wns::simulator::Time now = wns::simulator::getEventScheduler()->getTime();
     wns::simulator::Time frameTxDuration = 
-        getFUN()->getCommandReader(txDurationProviderCommandName)->
+        txDurationProviderReader->
             readCommand<wifimac::convergence::TxDurationProviderCommand>(
                 compound->getCommandPool())->getDuration();
 
@@ -551,10 +559,10 @@ FrameSynchronization::traceIncoming(wns::ldk::CompoundPtr compound)
     objdoc["Transmission"]["Subchannel"] = wns::probe::bus::json::Number(srcAdr.getInteger());
     
 
-    wns::Power rxPower = getFUN()->getCommandReader(phyUserCommandName)->
+    wns::Power rxPower = phyUserReader->
         readCommand<wifimac::convergence::PhyUserCommand>(
             compound->getCommandPool())->local.rxPower;
-    wns::Power interference = getFUN()->getCommandReader(phyUserCommandName)->
+    wns::Power interference = phyUserReader->
         readCommand<wifimac::convergence::PhyUserCommand>(
             compound->getCommandPool())->local.interference;
 
@@ -41,6 +41,7 @@
 
 #include <WNS/ldk/probe/Probe.hpp>
 #include <WNS/probe/bus/ContextCollector.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace convergence {
 
@@ -123,9 +124,13 @@ namespace wifimac { namespace convergence {
 
         const std::string managerName;
         const std::string crcCommandName;
+        wns::ldk::CommandReaderInterface* crcReader;
         const std::string phyUserCommandName;
+        wns::ldk::CommandReaderInterface* phyUserReader;
         const std::string errorModellingCommandName;
+        wns::ldk::CommandReaderInterface* errorModellingReader;
         const std::string txDurationProviderCommandName;
+        wns::ldk::CommandReaderInterface* txDurationProviderReader;
         const std::string sinrMIBServiceName;
 
         int numSpatialStreamsLastPreambleFragment;
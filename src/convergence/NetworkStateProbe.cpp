@@ -50,6 +50,7 @@ NetworkStateProbe::NetworkStateProbe(wns::ldk::fun::FUN* fun, const wns::pyconfi
 
     logger(config.get("logger")),
     txDurationProviderCommandName(config.get<std::string>("txDurationProviderCommandName")),
+    txDurationProviderReader(NULL),
     localNetworkState(),
     isTx(),
     curTxCompound(),
@@ -77,6 +78,12 @@ NetworkStateProbe::~NetworkStateProbe()
     delete isTx;
 }
 
+void
+NetworkStateProbe::onFUNCreated()
+{
+    txDurationProviderReader = getFUN()->getCommandReader(txDurationProviderCommandName);
+}
+
 void
 NetworkStateProbe::processOutgoing(const  wns::ldk::CompoundPtr& compound)
 {
@@ -87,7 +94,7 @@ NetworkStateProbe::processOutgoing(const  wns::ldk::CompoundPtr& compound)
     }
 
     curTxCompound = compound;
-    curFrameTxDuration = getFUN()->getCommandReader(txDurationProviderCommandName)->
+    curFrameTxDuration = txDurationProviderReader->
         readCommand<wifimac::convergence::TxDurationProviderCommand>(compound->getCommandPool())->getDuration();
 
     setTimeout(curFrameTxDuration);
@@ -107,7 +114,7 @@ NetworkStateProbe::onTimeout()
 void
 NetworkStateProbe::processIncoming(const wns::ldk::CompoundPtr& compound)
 {
-    wns::simulator::Time frameTxDuration = getFUN()->getCommandReader(txDurationProviderCommandName)->
+    wns::simulator::Time frameTxDuration = txDurationProviderReader->
         readCommand<wifimac::convergence::TxDurationProviderCommand>(compound->getCommandPool())->getDuration();
 
     isTx->set(0);
@@ -40,6 +40,7 @@
 #include <WNS/probe/bus/ContextCollector.hpp>
 #include <WNS/probe/bus/ContextProvider.hpp>
 #include <WNS/events/CanTimeout.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace convergence {
 
@@ -63,6 +64,8 @@ namespace wifimac { namespace convergence {
         NetworkStateProbe(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& config);
         virtual ~NetworkStateProbe();
 
+        virtual void onFUNCreated();
+
     private:
         /** @brief Processor Interface Implementation */
         void
@@ -80,6 +83,7 @@ namespace wifimac { namespace convergence {
 
         /** @brief Name of the command that holds the frame duration */
         std::string txDurationProviderCommandName;
+        wns::ldk::CommandReaderInterface* txDurationProviderReader;
 
         /** @brief Probe the (local) network state */
         wns::probe::bus::ContextCollectorPtr localNetworkState;
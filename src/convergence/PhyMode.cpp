@@ -33,110 +33,128 @@
 
 using namespace wifimac::convergence;
 
+namespace {
+    const char* modulationNames[numModulations] = {"BPSK", "QPSK", "QAM16", "QAM64"};
+    const char* codingRateNames[numCodingRates] = {"1/2", "2/3", "3/4", "5/6"};
+    const char* preambleModeNames[numPreambleModes] = {"Basic", "HT-Mix", "HT-GF"};
+}
+
+const unsigned int PhyMode::maxSpatialStreams;
+
 MCS::MCS():
-    modulation("ERROR"),
-    codingRate("ERROR"),
-    minSINR(),
-    index(0),
+    modulationId(numModulations),
+    rateId(numCodingRates),
     nominator(0),
-    denominator(1)
-{}
-
-MCS::MCS(const MCS& other):
-    modulation(other.modulation),
-    codingRate(other.codingRate),
-    nominator(other.nominator),
-    denominator(other.denominator),
-    index(other.index),
-    minSINR(other.minSINR)
+    denominator(1),
+    index(0),
+    minSINR()
 {}
 
 MCS::MCS(const wns::pyconfig::View& config) :
-    modulation(config.get<std::string>("modulation")),
-    codingRate(config.get<std::string>("codingRate")),
-    minSINR(config.get<wns::Ratio>("minSINR")),
-    index(0),
+    modulationId(numModulations),
+    rateId(numCodingRates),
     nominator(1),
-    denominator(1)
+    denominator(1),
+    index(0),
+    minSINR(config.get<wns::Ratio>("minSINR"))
 {
-    this->setMCS(modulation, codingRate);
+    this->setMCS(config.get<std::string>("modulation"), config.get<std::string>("codingRate"));
 }
 
 MCS::MCS(const wifimac::management::protocolCalculatorPlugins::ConfigGetter& config):
-    modulation(config.get<char*>("modulation", "s")),
-    codingRate(config.get<char*>("codingRate", "s")),
-    minSINR(wns::Ratio::from_dB(0.0)),
-    index(0),
+    modulationId(numModulations),
+    rateId(numCodingRates),
     nominator(1),
-    denominator(1)
+    denominator(1),
+    index(0),
+    minSINR(wns::Ratio::from_dB(0.0))
 {
     std::istringstream os(config.get<char*>("minSINR", "s"));
     os >> minSINR;
 
-    this->setMCS(modulation, codingRate);
+    this->setMCS(config.get<char*>("modulation", "s"), config.get<char*>("codingRate", "s"));
 }
 
 std::string MCS::getModulation() const
 {
-    return this->modulation;
+    return (modulationId < numModulations) ? modulationNames[modulationId] : "ERROR";
 }
 
 std::string MCS::getRate() const
 {
-    return this->codingRate;
+    return (rateId < numCodingRates) ? codingRateNames[rateId] : "ERROR";
 }
 
 void MCS::setMCS(const std::string& newModulation, const std::string& newCodingRate)
 {
-    assure(newModulation == "BPSK" or
-           newModulation == "QPSK" or
-           newModulation == "QAM16" or
-           newModulation == "QAM64",
-           "Unknown new modulation" << newModulation);
-    assure(newCodingRate == "1/2" or
-           newCodingRate == "2/3" or
-           newCodingRate == "3/4" or
-           newCodingRate == "5/6",
-           "Unknown new coding rate" << newCodingRate);
-
-    codingRate = newCodingRate;
-    modulation = newModulation;
-
-    if(modulation == "BSPK")
+    modulationId = numModulations;
+    for (int i = 0; i < numModulations; ++i)
     {
-        nominator = 1;
+        if(newModulation == modulationNames[i])
+        {
+            modulationId = static_cast<ModulationId>(i);
+        }
     }
-    else if(modulation == "QPSK")
+    rateId = numCodingRates;
+    for (int i = 0; i < numCodingRates; ++i)
     {
-        nominator = 2;
+        if(newCodingRate == codingRateNames[i])
+        {
+            rateId = static_cast<CodingRateId>(i);
+        }
     }
-    else if(modulation == "QAM16")
+    // the ids index the error probability tables, so unknown names must not
+    // pass in release builds either
+    if(modulationId == numModulations)
     {
-        nominator = 4;
+        wns::Exception e;
+        e << "Unknown new modulation " << newModulation;
+        throw wns::Exception(e);
     }
-    else if(modulation == "QAM64")
+    if(rateId == numCodingRates)
     {
-        nominator = 6;
+        wns::Exception e;
+        e << "Unknown new coding rate " << newCodingRate;
+        throw wns::Exception(e);
     }
 
-    if(codingRate == "1/2")
+    switch(modulationId)
     {
-        denominator = 2;
+    case BPSK:
+        nominator = 1;
+        break;
+    case QPSK:
+        nominator = 2;
+        break;
+    case QAM16:
+        nominator = 4;
+        break;
+    case QAM64:
+        nominator = 6;
+        break;
+    default:
+        break;
     }
-    else if(codingRate == "2/3")
+
+    switch(rateId)
     {
+    case Rate1_2:
+        denominator = 2;
+        break;
+    case Rate2_3:
         nominator *= 2;
         denominator = 3;
-    }
-    else if(codingRate == "3/4")
-    {
+        break;
+    case Rate3_4:
         nominator *= 3;
         denominator = 4;
-    }
-    else if(codingRate == "5/6")
-    {
+        break;
+    case Rate5_6:
         nominator *= 5;
         denominator = 6;
+        break;
+    default:
+        break;
     }
 }
 
@@ -161,43 +179,50 @@ bool MCS::operator !=(const MCS& rhs) const
 }
 
 PhyMode::PhyMode():
-    spatialStreams(),
+    numSpatialStreams(0),
     numberOfDataSubcarriers(0),
-    plcpMode("ERROR"),
+    plcpMode(numPreambleModes),
     guardIntervalDuration(0)
 {}
 
 PhyMode::PhyMode(const wns::pyconfig::View& config) :
-    spatialStreams(),
+    numSpatialStreams(0),
     numberOfDataSubcarriers(config.get<unsigned int>("numberOfDataSubcarriers")),
-    plcpMode(config.get<std::string>("plcpMode")),
+    plcpMode(toPreambleModeId(config.get<std::string>("plcpMode"))),
     guardIntervalDuration(config.get<wns::simulator::Time>("guardIntervalDuration"))
 {
     assure(config.get<int>("len(spatialStreams)") > 0,
            "cannot have less than 1 spatial stream");
-    assure(plcpMode == "Basic" or plcpMode == "HT-Mix" or plcpMode == "HT-GF",
+    assure(plcpMode != numPreambleModes,
            "Unknown plcpMode");
     assure(guardIntervalDuration == 0.8e-6 or guardIntervalDuration == 0.4e-6,
            "Unknown guard interval");
     assure(numberOfDataSubcarriers > 0,
            "cannot have less than 1 data subcarriers");
 
+    if(config.get<int>("len(spatialStreams)") > static_cast<int>(maxSpatialStreams))
+    {
+        wns::Exception e;
+        e << "cannot have more than " << maxSpatialStreams << " spatial streams";
+        throw wns::Exception(e);
+    }
+
     for (int i = 0; i < config.get<int>("len(spatialStreams)"); ++i)
     {
         std::string s = "spatialStreams[" + wns::Ttos(i) + "]";
-        spatialStreams.push_back(MCS(config.get(s)));
+        spatialStreams[numSpatialStreams++] = MCS(config.get(s));
     }
 }
 
 PhyMode::PhyMode(const wifimac::management::protocolCalculatorPlugins::ConfigGetter& config) :
-    spatialStreams(),
+    numSpatialStreams(0),
     numberOfDataSubcarriers(config.get<unsigned int>("numberOfDataSubcarriers", "I")),
-    plcpMode(config.get<char*>("plcpMode", "s")),
+    plcpMode(toPreambleModeId(config.get<char*>("plcpMode", "s"))),
     guardIntervalDuration(config.get<wns::simulator::Time>("guardIntervalDuration", "d"))
 {
     assure(config.length("spatialStreams") > 0,
            "cannot have less than 1 spatial stream");
-    assure(plcpMode == "Basic" or plcpMode == "HT-Mix" or plcpMode == "HT-GF",
+    assure(plcpMode != numPreambleModes,
            "Unknown plcpMode");
     assure(guardIntervalDuration == 0.8e-6 or guardIntervalDuration == 0.4e-6,
            "Unknown guard interval");
@@ -205,45 +230,93 @@ PhyMode::PhyMode(const wifimac::management::protocolCalculatorPlugins::ConfigGet
            "cannot have less than 1 data subcarriers");
 
     int len = config.length("spatialStreams");
+    if(len > static_cast<int>(maxSpatialStreams))
+    {
+        wns::Exception e;
+        e << "cannot have more than " << maxSpatialStreams << " spatial streams";
+        throw wns::Exception(e);
+    }
+
     for (int i = 0; i < len; ++i)
     {
         MCS m(config.get("spatialStreams", i));
-        spatialStreams.push_back(m);
+        spatialStreams[numSpatialStreams++] = m;
+    }
+}
+
+PreambleModeId
+PhyMode::toPreambleModeId(const std::string& pm)
+{
+    for (int i = 0; i < numPreambleModes; ++i)
+    {
+        if(pm == preambleModeNames[i])
+        {
+            return static_cast<PreambleModeId>(i);
+        }
     }
+    return numPreambleModes;
+}
+
+std::string PhyMode::getPreambleMode() const
+{
+    return (plcpMode < numPreambleModes) ? preambleModeNames[plcpMode] : "ERROR";
+}
+
+void PhyMode::setPreambleMode(const std::string& pm)
+{
+    this->plcpMode = toPreambleModeId(pm);
+    assure(this->plcpMode != numPreambleModes, "Unknown plcpMode " << pm);
 }
 
 Bit PhyMode::getDataBitsPerSymbol() const
 {
     unsigned int dbps = 0;
-    if((spatialStreams.size() == 0) or (numberOfDataSubcarriers == 0))
+    if((numSpatialStreams == 0) or (numberOfDataSubcarriers == 0))
     {
         return 0;
     }
 
-    for (std::vector<MCS>::const_iterator it = spatialStreams.begin();
-         it != spatialStreams.end();
-         ++it)
+    for (unsigned int i = 0; i < numSpatialStreams; ++i)
     {
-        dbps += (numberOfDataSubcarriers * it->nominator / it->denominator);
+        dbps += (numberOfDataSubcarriers * spatialStreams[i].nominator / spatialStreams[i].denominator);
     }
     return(dbps);
 }
 
 void PhyMode::setUniformMCS(const MCS& mcs, unsigned int numSS)
 {
-    this->spatialStreams.assign(numSS, mcs);
+    if(numSS > maxSpatialStreams)
+    {
+        wns::Exception e;
+        e << "cannot have more than " << maxSpatialStreams << " spatial streams, requested " << numSS;
+        throw wns::Exception(e);
+    }
+
+    // mcs may refer to one of the current streams
+    const MCS m = mcs;
+    for (unsigned int i = 0; i < numSS; ++i)
+    {
+        this->spatialStreams[i] = m;
+    }
+    this->numSpatialStreams = numSS;
 }
 
 void PhyMode::setSpatialStreams(const std::vector<MCS>& ss)
 {
     assure(ss.size() > 0, "ERROR: No spatial streams");
+    if(ss.size() > maxSpatialStreams)
+    {
+        wns::Exception e;
+        e << "cannot have more than " << maxSpatialStreams << " spatial streams, requested " << ss.size();
+        throw wns::Exception(e);
+    }
 
-    this->spatialStreams.clear();
+    this->numSpatialStreams = 0;
     for(std::vector<MCS>::const_iterator it = ss.begin();
         it != ss.end();
         ++it)
     {
-        this->spatialStreams.push_back(*it);
+        this->spatialStreams[this->numSpatialStreams++] = *it;
     }
 }
 
@@ -254,26 +327,22 @@ bool PhyMode::operator <(const PhyMode& rhs) const
 
 bool PhyMode::operator ==(const PhyMode& rhs) const
 {
-    assure(spatialStreams.size() > 0, "number of spatial streams not set in lhs");
+    assure(numSpatialStreams > 0, "number of spatial streams not set in lhs");
     assure(numberOfDataSubcarriers > 0, "number of DataSubcarriers not set in lhs");
-    assure(plcpMode != "ERROR", "plcpMode not set in lhs");
+    assure(plcpMode != numPreambleModes, "plcpMode not set in lhs");
 
-    assure(rhs.spatialStreams.size() > 0, "number of spatial streams not set in rhs");
+    assure(rhs.numSpatialStreams > 0, "number of spatial streams not set in rhs");
     assure(rhs.numberOfDataSubcarriers > 0, "number of DataSubcarriers not set in rhs");
-    assure(rhs.plcpMode != "ERROR", "plcpMode not set in rhs");
+    assure(rhs.plcpMode != numPreambleModes, "plcpMode not set in rhs");
 
-    if(spatialStreams.size() != rhs.spatialStreams.size())
+    if(numSpatialStreams != rhs.numSpatialStreams)
     {
         return false;
     }
 
-    std::vector<MCS>::const_iterator it = spatialStreams.begin();
-    std::vector<MCS>::const_iterator itRHS = rhs.spatialStreams.begin();
-    for(;
-        (it != spatialStreams.end()) and (itRHS != rhs.spatialStreams.end());
-        ++it, ++itRHS)
+    for(unsigned int i = 0; i < numSpatialStreams; ++i)
     {
-        if((*it) != (*itRHS))
+        if(spatialStreams[i] != rhs.spatialStreams[i])
         {
             return false;
         }
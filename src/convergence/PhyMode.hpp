@@ -25,6 +25,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *
  ******************************************************************************/
+
 #ifndef WIFIMAC_CONVERGENCE_PHYMODE_HPP
 #define WIFIMAC_CONVERGENCE_PHYMODE_HPP
 
@@ -34,6 +35,7 @@
 #include <WNS/pyconfig/View.hpp>
 #include <WNS/logger/Logger.hpp>
 #include <WNS/Ttos.hpp>
+#include <WNS/Assure.hpp>
 #include <WNS/simulator/Bit.hpp>
 
 #include <WIFIMAC/management/protocolCalculatorPlugins/ConfigGetter.hpp>
@@ -45,18 +47,60 @@ namespace wifimac { namespace convergence {
 
     class PhyMode;
 
+    /**
+     * @brief Modulation of a MCS, resolved from its name at construction
+     */
+    enum ModulationId {
+        BPSK,
+        QPSK,
+        QAM16,
+        QAM64,
+        numModulations
+    };
+
+    /**
+     * @brief Coding rate of a MCS, resolved from its name at construction
+     */
+    enum CodingRateId {
+        Rate1_2,
+        Rate2_3,
+        Rate3_4,
+        Rate5_6,
+        numCodingRates
+    };
+
+    /**
+     * @brief PLCP preamble mode of a PhyMode, resolved from its name
+     */
+    enum PreambleModeId {
+        BasicPreamble,
+        HTMixPreamble,
+        HTGFPreamble,
+        numPreambleModes
+    };
+
+    /**
+     * @brief Modulation and coding scheme
+     *
+     * The modulation and coding rate are stored as ids, their names are only
+     * generated on request. Hence, a MCS is trivially copyable.
+     */
     class MCS {
         // PhyMode needs to access the nominator and denominator
         friend class PhyMode;
     public:
         MCS();
         MCS(const wns::pyconfig::View& config);
-        MCS(const MCS& other);
         MCS(const wifimac::management::protocolCalculatorPlugins::ConfigGetter& config);
 
         std::string getModulation() const;
         std::string getRate() const;
 
+        ModulationId getModulationId() const
+            { return this->modulationId; };
+        CodingRateId getRateId() const
+            { return this->rateId; };
+
         void
         setIndex(unsigned int index)
             { this->index = index;};
@@ -76,8 +120,8 @@ namespace wifimac { namespace convergence {
     private:
         void setMCS(const std::string& newModulation, const std::string& newCodingRate);
 
-        std::string modulation;
-        std::string codingRate;
+        ModulationId modulationId;
+        CodingRateId rateId;
 
         unsigned int nominator;
         unsigned int denominator;
@@ -99,9 +143,19 @@ namespace wifimac { namespace convergence {
 	 * - Method to compute the number of symbols for a given number of data bits
 	 * - Description (modulation, codingRate, index)
      * - Number of spatial streams
+     *
+     * The spatial streams are stored inline up to the maximum number of
+     * spatial streams of IEEE 802.11n, the preamble mode as id. Hence, a
+     * PhyMode is trivially copyable and can be passed by value in commands
+     * without any heap allocation.
 	 */
     class PhyMode {
     public:
+        /**
+         * @brief Maximum number of spatial streams (IEEE 802.11n)
+         */
+        static const unsigned int maxSpatialStreams = 4;
+
         /** Constructors **/
         PhyMode();
         PhyMode(const wns::pyconfig::View& config);
@@ -116,7 +170,7 @@ namespace wifimac { namespace convergence {
          * @brief Get the number of spatial streams
          */
         unsigned int getNumberOfSpatialStreams() const
-            { return this->spatialStreams.size(); };
+            { return this->numSpatialStreams; };
 
         void setMCS(const MCS& mcs)
             { this->setUniformMCS(mcs, 1); };
@@ -124,7 +178,17 @@ namespace wifimac { namespace convergence {
         void setUniformMCS(const MCS& mcs, unsigned int numSS);
 
         std::vector<MCS> getSpatialStreams() const
-            { return this->spatialStreams; };
+            { return std::vector<MCS>(this->spatialStreams, this->spatialStreams + this->numSpatialStreams); };
+
+        /**
+         * @brief MCS of one spatial stream without copying all streams
+         */
+        const MCS& getMCS(unsigned int stream) const
+            {
+                assure(stream < this->numSpatialStreams,
+                       "stream " << stream << " out of range, only " << this->numSpatialStreams << " spatial streams");
+                return this->spatialStreams[stream];
+            };
 
         void setSpatialStreams(const std::vector<MCS>& ss);
 
@@ -136,9 +200,12 @@ namespace wifimac { namespace convergence {
         void setNumberOfDataSubcarriers(unsigned int ds)
             { this->numberOfDataSubcarriers = ds; };
 
-        std::string getPreambleMode() const
-            { return this->plcpMode;};
-        void setPreambleMode(std::string pm)
+        std::string getPreambleMode() const;
+        void setPreambleMode(const std::string& pm);
+
+        PreambleModeId getPreambleModeId() const
+            { return this->plcpMode;}
+        void setPreambleModeId(PreambleModeId pm)
             { this->plcpMode = pm;}
 
         wns::simulator::Time getGuardIntervalDuration() const
@@ -157,21 +224,25 @@ namespace wifimac { namespace convergence {
         bool operator !=(const PhyMode& rhs) const;
 
     private:
-        std::vector<MCS> spatialStreams;
+        /**
+         * @brief Resolve the name of a preamble mode
+         */
+        static PreambleModeId
+        toPreambleModeId(const std::string& pm);
+
+        MCS spatialStreams[maxSpatialStreams];
+        unsigned int numSpatialStreams;
         unsigned int numberOfDataSubcarriers;
-        std::string plcpMode;
+        PreambleModeId plcpMode;
         wns::simulator::Time guardIntervalDuration;
     };
 
     inline std::ostream& operator<< (std::ostream& s, const PhyMode& p)
     {
         s << "|";
-        std::vector<MCS> ss = p.getSpatialStreams();
-        for (std::vector<MCS>::iterator it = ss.begin();
-             it != ss.end();
-             ++it)
+        for (unsigned int i = 0; i < p.getNumberOfSpatialStreams(); ++i)
         {
-            s << (*it) << "|";
+            s << p.getMCS(i) << "|";
         }
         s << "*" << wns::Ttos(p.getNumberOfDataSubcarriers())
                   << " (-> " << wns::Ttos(p.getDataBitsPerSymbol()) << " dbps)";
@@ -28,10 +28,15 @@
 
 #include <WIFIMAC/convergence/PhyModeProvider.hpp>
 
+#include <WNS/Exception.hpp>
+
+#include <map>
 #include <stdio.h>
 
 using namespace wifimac::convergence;
 
+const double PhyModeProvider::sinrTableResolution = 0.25;
+
 PhyModeProvider::PhyModeProvider(const wns::pyconfig::View& config) :
     switchingPointOffset(config.get<wns::Ratio>("switchingPointOffset"))
 {
@@ -39,6 +44,7 @@ PhyModeProvider::PhyModeProvider(const wns::pyconfig::View& config) :
 
     char bf[15];
 
+    std::map<wns::Ratio, MCS> sinr2mcs;
     for (int id=0; id < config.get<int>("len(MCSs)"); ++id)
     {
         sprintf(bf, "MCSs[%d]", id);
@@ -49,13 +55,28 @@ PhyModeProvider::PhyModeProvider(const wns::pyconfig::View& config) :
         sinr2mcs[mcs.getMinSINR()] = mcs;
     }
 
-    unsigned int index = 0;
     for(std::map<wns::Ratio, MCS>::iterator it = sinr2mcs.begin();
         it != sinr2mcs.end();
         ++it)
     {
-        it->second.setIndex(index);
-        ++index;
+        it->second.setIndex(mcss.size());
+        mcss.push_back(it->second);
+        minSINRdB.push_back(it->first.get_dB());
+    }
+
+    // For each step, store the highest MCS whose minSINR is below the step
+    const unsigned int numSteps =
+        static_cast<unsigned int>((minSINRdB.back() - minSINRdB.front()) / sinrTableResolution) + 1;
+    sinrTable.resize(numSteps);
+    unsigned int index = 0;
+    for(unsigned int step = 0; step < numSteps; ++step)
+    {
+        const double sinr = minSINRdB.front() + step * sinrTableResolution;
+        while(index + 1 < minSINRdB.size() and minSINRdB[index + 1] < sinr)
+        {
+            ++index;
+        }
+        sinrTable[step] = index;
     }
 
     wns::pyconfig::View configPreamble = config.getView("phyModePreamble");
@@ -65,39 +86,57 @@ PhyModeProvider::PhyModeProvider(const wns::pyconfig::View& config) :
     defaultPhyMode = PhyMode(configPhyMode);
 }
 
+unsigned int
+PhyModeProvider::findIndex(const MCS& mcs) const
+{
+    // MCSs handed out by this provider carry their index
+    if(mcs.getIndex() < mcss.size() and
+       mcss[mcs.getIndex()].getMinSINR() == mcs.getMinSINR())
+    {
+        return(mcs.getIndex());
+    }
+
+    for(unsigned int index = 0; index < mcss.size(); ++index)
+    {
+        if(mcss[index].getMinSINR() == mcs.getMinSINR())
+        {
+            return(index);
+        }
+    }
+    throw wns::Exception("MCS is not known by the PhyModeProvider");
+}
+
 void
 PhyModeProvider::mcsUp(PhyMode& pm) const
 {
-    std::map<wns::Ratio, MCS>::const_iterator it = sinr2mcs.find(pm.getSpatialStreams()[0].getMinSINR());
-    ++it;
-    if(it != sinr2mcs.end())
+    unsigned int index = findIndex(pm.getMCS(0));
+    if(index + 1 < mcss.size())
     {
-        pm.setUniformMCS(it->second, pm.getNumberOfSpatialStreams());
+        pm.setUniformMCS(mcss[index + 1], pm.getNumberOfSpatialStreams());
     }
 }
 
 void
 PhyModeProvider::mcsDown(PhyMode& pm) const
 {
-    std::map<wns::Ratio, MCS>::const_iterator it = sinr2mcs.find(pm.getSpatialStreams()[0].getMinSINR());
-    if(it != sinr2mcs.begin())
+    unsigned int index = findIndex(pm.getMCS(0));
+    if(index > 0)
     {
-        --it;
-        pm.setUniformMCS(it->second, pm.getNumberOfSpatialStreams());
+        pm.setUniformMCS(mcss[index - 1], pm.getNumberOfSpatialStreams());
     }
 }
 
 bool
 PhyModeProvider::hasLowestMCS(const PhyMode& pm) const
 {
-    return(pm.getSpatialStreams()[0] == sinr2mcs.begin()->second);
+    return(pm.getMCS(0) == mcss.front());
 }
 
 
 bool
 PhyModeProvider::hasHighestMCS(const PhyMode& pm) const
 {
-    return(pm.getSpatialStreams()[0] == (--sinr2mcs.end())->second);
+    return(pm.getMCS(0) == mcss.back());
 }
 
 PhyMode
@@ -106,8 +145,8 @@ PhyModeProvider::getPreamblePhyMode(PhyMode pmFrame) const
     PhyMode pm = preamblePhyMode;
     pm.setGuardIntervalDuration(pmFrame.getGuardIntervalDuration());
     // Preamble has one spatial stream only
-    //pm.setUniformMCS(preamblePhyMode.getSpatialStreams()[0], pmFrame.getNumberOfSpatialStreams());
-    pm.setPreambleMode(pmFrame.getPreambleMode());
+    //pm.setUniformMCS(preamblePhyMode.getMCS(0), pmFrame.getNumberOfSpatialStreams());
+    pm.setPreambleModeId(pmFrame.getPreambleModeId());
 
     return(pm);
 }
@@ -122,25 +161,45 @@ PhyModeProvider::getDefaultPhyMode() const
 MCS
 PhyModeProvider::getMCS(wns::Ratio sinr) const
 {
-    sinr = sinr - switchingPointOffset;
+    return(mcss[getMCSIndex(sinr)]);
+}
 
-    if(sinr < sinr2mcs.begin()->second.getMinSINR())
+unsigned int
+PhyModeProvider::getMCSIndex(wns::Ratio sinr) const
+{
+    const double sinrdB = (sinr - switchingPointOffset).get_dB();
+
+    if(sinrdB <= minSINRdB.front())
     {
-        return(sinr2mcs.begin()->second);
+        return(0);
     }
 
-    if(sinr > (--sinr2mcs.end())->second.getMinSINR())
+    if(sinrdB > minSINRdB.back())
     {
-        return( (--sinr2mcs.end())->second);
+        return(mcss.size() - 1);
     }
 
-    std::map<wns::Ratio, MCS>::const_iterator it = sinr2mcs.lower_bound(sinr);
-    --it;
-    return(it->second);
+    // the step gives the MCS up to rounding, the highest MCS with minSINR
+    // below sinr is at most one threshold away
+    unsigned int step = static_cast<unsigned int>((sinrdB - minSINRdB.front()) / sinrTableResolution);
+    if(step >= sinrTable.size())
+    {
+        step = sinrTable.size() - 1;
+    }
+    unsigned int index = sinrTable[step];
+    while(index + 1 < mcss.size() and minSINRdB[index + 1] < sinrdB)
+    {
+        ++index;
+    }
+    while(index > 0 and minSINRdB[index] >= sinrdB)
+    {
+        --index;
+    }
+    return(index);
 }
 
 wns::Ratio
 PhyModeProvider::getMinSINR() const
 {
-    return(sinr2mcs.begin()->second.getMinSINR());
+    return(mcss.front().getMinSINR());
 }
@@ -33,6 +33,8 @@
 
 #include <WNS/PowerRatio.hpp>
 
+#include <vector>
+
 namespace wifimac { namespace convergence {
 
 	/**
@@ -78,11 +80,35 @@ namespace wifimac { namespace convergence {
         /** @brief return the optimal MCS for a suggested sinr */
         MCS getMCS(wns::Ratio postSINR) const;
 
+        /**
+         * @brief return the index of the optimal MCS for a suggested sinr
+         *
+         * The MCSs are indexed in the order of their minimum SINR, the lookup
+         * uses a table over the quantized SINR in dB.
+         */
+        unsigned int getMCSIndex(wns::Ratio postSINR) const;
+
         /** @brief returns the minimal SINR for a connection */
         wns::Ratio getMinSINR() const;
 
     private:
-        std::map<wns::Ratio, MCS> sinr2mcs;
+        /** @brief Index of the given MCS in mcss */
+        unsigned int findIndex(const MCS& mcs) const;
+
+        /** @brief All MCSs, ordered by their minimum SINR */
+        std::vector<MCS> mcss;
+
+        /** @brief Minimum SINR of the MCSs in dB, same order as mcss */
+        std::vector<double> minSINRdB;
+
+        /**
+         * @brief Index of the optimal MCS for each SINR step, starting at the
+         * lowest minSINR
+         */
+        std::vector<unsigned int> sinrTable;
+
+        /** @brief SINR step of the sinrTable in dB */
+        static const double sinrTableResolution;
 
         wns::Ratio switchingPointOffset;
 
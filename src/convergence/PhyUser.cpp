@@ -39,7 +39,6 @@
 #include <WNS/ldk/concatenation/Concatenation.hpp>
 
 #include <boost/numeric/ublas/matrix.hpp>
-#include <boost/bind.hpp>
 
 using namespace wifimac::convergence;
 
@@ -59,12 +58,18 @@ PhyUser::PhyUser(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& _config) :
     phyModes(config.getView("myConfig.phyModesDeliverer")),
     managerName(config.get<std::string>("managerName")),
     txDurationProviderCommandName(config.get<std::string>("txDurationProviderCommandName")),
+    txDurationProviderReader(NULL),
     txrxTurnaroundDelay(config.get<wns::simulator::Time>("myConfig.txrxTurnaroundDelay")),
     bfEnabled(config.get<bool>("myConfig.bfEnabled")),
     phyUserStatus(receiving),
     currentTxCompound(),
-    lastTxRxTurnaround(0.0)
+    lastTxRxTurnaround(0.0),
+    postSINRFactors(),
+    nodeByMAC()
 {
+    txParameters.destination = NULL;
+    txParameters.numSpatialStreams = 0;
+
     tune.frequency = config.get<double>("myConfig.initFrequency");
     tune.bandwidth = config.get<double>("myConfig.initBandwidthMHz");
     tune.numberOfSubCarrier = 1;
@@ -78,7 +83,20 @@ PhyUser::~PhyUser()
 
 void PhyUser::onFUNCreated()
 {
+    txDurationProviderReader = getFUN()->getCommandReader(txDurationProviderCommandName);
     friends.manager = getFUN()->findFriend<wifimac::lowerMAC::Manager*>(managerName);
+
+    // precompute the post-SINR factors for all MIMO configurations
+    const unsigned int numAntennas = friends.manager->getNumAntennas();
+    postSINRFactors.assign(PhyMode::maxSpatialStreams + 1, std::vector<wns::Ratio>());
+    for(unsigned int nss = 1; nss <= PhyMode::maxSpatialStreams; ++nss)
+    {
+        postSINRFactors[nss].resize(numAntennas + 1);
+        for(unsigned int numRx = nss; numRx <= numAntennas; ++numRx)
+        {
+            postSINRFactors[nss][numRx] = computeExpectedPostSINRFactor(nss, numRx);
+        }
+    }
 } // onFUNCreated
 
 bool PhyUser::doIsAccepting(const wns::ldk::CompoundPtr& /* compound */) const
@@ -98,60 +116,24 @@ void PhyUser::doSendData(const wns::ldk::CompoundPtr& compound)
         this->wns::Subject<ITxStartEnd>::forEachObserver(OnTxStartEnd(compound, start));
     }
 
-    wns::simulator::Time frameTxDuration = getFUN()->getCommandReader(txDurationProviderCommandName)->
+    wns::simulator::Time frameTxDuration = txDurationProviderReader->
         readCommand<wifimac::convergence::TxDurationProviderCommand>(compound->getCommandPool())->getDuration();
 
     PhyUserCommand* command = activateCommand(compound->getCommandPool());
 
-    wns::Power defaultTxPower = getDataTransmissionService()->getMaxPowerPerSubband();
-
-    // to schedule the startBroadcast function, we have to indicate to
-    // boost::bind the correct function, as startBroadcast has two different
-    // signatures (with number of streams and phyMode). Therefore, we first
-    // create a variable of the desired function signature type and assign using
-    // desired member function.  This will resolve the correct function thanks
-    // to the signature including the argument types.
+    // store the transmission parameters and schedule the start of the
+    // transmission; the end is handled by the timeout below
+    txParameters.txPower = getDataTransmissionService()->getMaxPowerPerSubband();
+    txParameters.numSpatialStreams = friends.manager->getPhyMode(compound->getCommandPool()).getNumberOfSpatialStreams();
     if(bfEnabled and friends.manager->getReceiverAddress(compound->getCommandPool()).isValid())
     {
-        void (wns::service::phy::ofdma::NonBFTransmission::*fn)(wns::osi::PDUPtr, wns::node::Interface*, int, wns::Power, int) =
-            &wns::service::phy::ofdma::NonBFTransmission::startUnicast;
-
-        wns::service::dll::UnicastAddress destination = friends.manager->getReceiverAddress(compound->getCommandPool());
-        wns::node::Interface* n = this->getFUN()->getLayer<dll::ILayer2*>()->getStationManager()->getStationByMAC(destination)->getNode();
-
-        // Now boost::bind can be used to schedue the start of the transmission
-        wns::simulator::getEventScheduler()->scheduleDelay(
-            boost::bind(fn,
-                        this->getDataTransmissionService(),
-                        compound,
-                        n,
-                        0,
-                        defaultTxPower,
-                        friends.manager->getPhyMode(compound->getCommandPool()).getNumberOfSpatialStreams()),
-            0.0);
+        txParameters.destination = getNodeByMAC(friends.manager->getReceiverAddress(compound->getCommandPool()));
     }
     else
     {
-        void (wns::service::phy::ofdma::NonBFTransmission::*fn)(wns::osi::PDUPtr, int, wns::Power, int) =
-            &wns::service::phy::ofdma::NonBFTransmission::startBroadcast;
-
-        // Now boost::bind can be used to schedue the start of the transmission
-        wns::simulator::getEventScheduler()->scheduleDelay(
-            boost::bind(fn,
-                        this->getDataTransmissionService(),
-                        compound,
-                        0,
-                        defaultTxPower,
-                        friends.manager->getPhyMode(compound->getCommandPool()).getNumberOfSpatialStreams()),
-            0.0);
+        txParameters.destination = NULL;
     }
-    // schedule end of transmission similarly
-    wns::simulator::getEventScheduler()->scheduleDelay(
-        boost::bind(&wns::service::phy::ofdma::DataTransmission::stopTransmission,
-                    this->getDataTransmissionService(),
-                    compound,
-                    0),
-        frameTxDuration);
+    wns::simulator::getEventScheduler()->scheduleDelay(TxStart(this), 0.0);
 
     MESSAGE_SINGLE(NORMAL, logger, "Transmission, rx disabled for " << frameTxDuration);
     if(phyUserStatus == txrxTurnaround)
@@ -169,6 +151,44 @@ void PhyUser::doSendData(const wns::ldk::CompoundPtr& compound)
 
 } // doSendData
 
+void PhyUser::startTransmission()
+{
+    assure(this->currentTxCompound, "currentTxCompound is NULL");
+
+    // startUnicast and startBroadcast are overloaded for the number of
+    // streams and the phyMode, the int argument selects the first
+    wns::service::phy::ofdma::NonBFTransmission* tx = this->getDataTransmissionService();
+    if(txParameters.destination != NULL)
+    {
+        tx->startUnicast(this->currentTxCompound,
+                         txParameters.destination,
+                         0,
+                         txParameters.txPower,
+                         txParameters.numSpatialStreams);
+    }
+    else
+    {
+        tx->startBroadcast(this->currentTxCompound,
+                           0,
+                           txParameters.txPower,
+                           txParameters.numSpatialStreams);
+    }
+} // startTransmission
+
+wns::node::Interface*
+PhyUser::getNodeByMAC(const wns::service::dll::UnicastAddress& mac)
+{
+    boost::unordered_map<int, wns::node::Interface*>::const_iterator it = nodeByMAC.find(mac.getInteger());
+    if(it != nodeByMAC.end())
+    {
+        return(it->second);
+    }
+
+    wns::node::Interface* n = this->getFUN()->getLayer<dll::ILayer2*>()->getStationManager()->getStationByMAC(mac)->getNode();
+    nodeByMAC[mac.getInteger()] = n;
+    return(n);
+} // getNodeByMAC
+
 void PhyUser::doOnData(const wns::ldk::CompoundPtr& compound)
 {
     assure(compound, "onData called with an invalid compound.");
@@ -190,18 +210,20 @@ void PhyUser::onData(wns::osi::PDUPtr pdu, wns::service::phy::power::PowerMeasur
         // During transmission, the receiver is off
         return;
     }
-    // FIRST: create a copy instead of working on the real compound
-    wns::ldk::CompoundPtr compound = wns::staticCast<wns::ldk::Compound>(pdu)->copy();
+    // The pdu is shared by all receivers of the transmission, hence the
+    // checks below only read from it. A copy is created only for frames
+    // that enter the receive chain.
+    wns::ldk::CompoundPtr received = wns::staticCast<wns::ldk::Compound>(pdu);
 
-    if(not getFUN()->getProxy()->commandIsActivated(compound->getCommandPool(), this))
+    if(not getFUN()->getProxy()->commandIsActivated(received->getCommandPool(), this))
     {
         // if the phyUserCommand is not activated, the compound was not send
         // from a WIFIMAC node!
         return;
     }
 
-    wns::simulator::Time frameRxDuration = getFUN()->getCommandReader(txDurationProviderCommandName)->
-        readCommand<wifimac::convergence::TxDurationProviderCommand>(compound->getCommandPool())->getDuration();
+    wns::simulator::Time frameRxDuration = txDurationProviderReader->
+        readCommand<wifimac::convergence::TxDurationProviderCommand>(received->getCommandPool())->getDuration();
 
     if(lastTxRxTurnaround > (wns::simulator::getEventScheduler()->getTime() - frameRxDuration))
     {
@@ -210,11 +232,11 @@ void PhyUser::onData(wns::osi::PDUPtr pdu, wns::service::phy::power::PowerMeasur
     }
 
     // check if we have enough antennas to receive all streams
-    unsigned int nss = friends.manager->getPhyMode(compound->getCommandPool()).getNumberOfSpatialStreams();
+    unsigned int nss = friends.manager->getPhyMode(received->getCommandPool()).getNumberOfSpatialStreams();
     if(nss > friends.manager->getNumAntennas())
     {
         MESSAGE_BEGIN(NORMAL, logger, m, "Transmission ");
-        m << "from " << friends.manager->getTransmitterAddress(compound->getCommandPool());
+        m << "from " << friends.manager->getTransmitterAddress(received->getCommandPool());
         m << " has " << nss;
         m << " spatial streams, but receiver has only " << friends.manager->getNumAntennas() << " antennas -> drop";
         MESSAGE_END();
@@ -223,12 +245,15 @@ void PhyUser::onData(wns::osi::PDUPtr pdu, wns::service::phy::power::PowerMeasur
     else
     {
         MESSAGE_BEGIN(NORMAL, logger, m, "Transmission ");
-        m << "from " << friends.manager->getTransmitterAddress(compound->getCommandPool());
+        m << "from " << friends.manager->getTransmitterAddress(received->getCommandPool());
         m << " has " << nss;
         m << " spatial streams, receiver has " << friends.manager->getNumAntennas() << " antennas";
         MESSAGE_END();
     }
 
+    // the frame is received -> work on a copy, not on the real compound
+    wns::ldk::CompoundPtr compound = received->copy();
+
     PhyUserCommand* phyCommand = getCommand(compound->getCommandPool());
 
     // store measured signal into Command
@@ -243,6 +268,17 @@ wns::Ratio PhyUser::getExpectedPostSINRFactor(unsigned int nss, unsigned int num
 {
     assure(numRx >= nss, "Nss must be smaller or equal to numRx");
 
+    if(nss < postSINRFactors.size() and numRx < postSINRFactors[nss].size())
+    {
+        return(postSINRFactors[nss][numRx]);
+    }
+    return(computeExpectedPostSINRFactor(nss, numRx));
+}
+
+wns::Ratio PhyUser::computeExpectedPostSINRFactor(unsigned int nss, unsigned int numRx)
+{
+    assure(numRx >= nss, "Nss must be smaller or equal to numRx");
+
     double cF = 1.0;
 
     double mimoCorrelation = 1.0;
@@ -283,10 +319,12 @@ void PhyUser::onTimeout()
     {
         // finished transmission, start turnaround
         MESSAGE_SINGLE(NORMAL, logger, "Timout, finished transmission");
+        assure(this->currentTxCompound, "currentTxCompound is NULL");
+        getDataTransmissionService()->stopTransmission(this->currentTxCompound, 0);
+
         phyUserStatus = txrxTurnaround;
         setTimeout(txrxTurnaroundDelay);
 
-        assure(this->currentTxCompound, "currentTxCompound is NULL");
         if(friends.manager->getFrameType(this->currentTxCompound->getCommandPool()) != PREAMBLE)
         {
             // signal tx end to MAC
@@ -45,6 +45,10 @@
 
 #include <WNS/ldk/fu/Plain.hpp>
 #include <WNS/ldk/Command.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
+
+#include <boost/unordered_map.hpp>
+#include <vector>
 
 namespace wifimac { namespace lowerMAC {
         class Manager;
@@ -126,6 +130,13 @@ namespace wifimac { namespace convergence {
         /** @brief Frequency tuning */
         void setFrequency(double frequency);
 
+        /**
+         * @brief Expected SINR gain of a MIMO reception with nss streams and
+         * numRx antennas
+         *
+         * Served from a table for all configurations with up to the number of
+         * antennas of this node, computed only for other configurations.
+         */
         wns::Ratio getExpectedPostSINRFactor(unsigned int nss, unsigned int numRx);
 
         bool isTransmitting() const
@@ -145,6 +156,41 @@ namespace wifimac { namespace convergence {
         // onTimeout realisation
         virtual void onTimeout();
 
+        /**
+         * @brief Scheduler callable for the start of the transmission
+         *
+         * Holds only the PhyUser, so that it fits into the callable without
+         * an allocation; the transmission parameters are kept in the PhyUser.
+         */
+        class TxStart
+        {
+        public:
+            TxStart(PhyUser* _phyUser):
+                phyUser(_phyUser)
+                {}
+
+            void operator()()
+                {
+                    phyUser->startTransmission();
+                }
+
+        private:
+            PhyUser* phyUser;
+        };
+        friend class TxStart;
+
+        /** @brief Starts the transmission of the currentTxCompound */
+        void startTransmission();
+
+        /** @brief Computes the post-SINR factor via the Cholesky decomposition
+         * of the MIMO channel covariance matrix */
+        static wns::Ratio
+        computeExpectedPostSINRFactor(unsigned int nss, unsigned int numRx);
+
+        /** @brief Returns the node of the given MAC address */
+        wns::node::Interface*
+        getNodeByMAC(const wns::service::dll::UnicastAddress& mac);
+
         wns::pyconfig::View config;
         wns::logger::Logger logger;
 
@@ -155,6 +201,7 @@ namespace wifimac { namespace convergence {
 
         const std::string managerName;
         const std::string txDurationProviderCommandName;
+        wns::ldk::CommandReaderInterface* txDurationProviderReader;
         const wns::simulator::Time txrxTurnaroundDelay;
         const bool bfEnabled;
 
@@ -172,6 +219,21 @@ namespace wifimac { namespace convergence {
 
         wns::ldk::CompoundPtr currentTxCompound;
         wns::simulator::Time lastTxRxTurnaround;
+
+        /** @brief Parameters of the transmission of the currentTxCompound */
+        struct TxParameters
+        {
+            /** @brief Receiver for beamformed unicast, NULL for broadcast */
+            wns::node::Interface* destination;
+            wns::Power txPower;
+            int numSpatialStreams;
+        } txParameters;
+
+        /** @brief Precomputed post-SINR factors, indexed by [nss][numRx] */
+        std::vector< std::vector<wns::Ratio> > postSINRFactors;
+
+        /** @brief Nodes by MAC address integer, filled on first use */
+        boost::unordered_map<int, wns::node::Interface*> nodeByMAC;
     };
 
 } // namespace convergence
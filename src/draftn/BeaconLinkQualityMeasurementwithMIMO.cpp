@@ -275,7 +275,8 @@ BeaconLinkQualityMeasurementwithMIMO::BeaconLinkQualityMeasurementwithMIMO(wns::
     logger(_config.get("logger")),
     config(_config),
     beaconInterval(config.get<wns::simulator::Time>("beaconInterval")),
-    phyUserCommandName(config.get<std::string>("phyUserCommandName"))
+    phyUserCommandName(config.get<std::string>("phyUserCommandName")),
+    phyUserReader(NULL)
 {
     friends.manager = NULL;
 
@@ -302,6 +303,7 @@ BeaconLinkQualityMeasurementwithMIMO::~BeaconLinkQualityMeasurementwithMIMO()
 void
 BeaconLinkQualityMeasurementwithMIMO::onFUNCreated()
 {
+    phyUserReader = getFUN()->getCommandReader(phyUserCommandName);
     friends.manager =  getFUN()->findFriend<wifimac::lowerMAC::Manager*>(config.get<std::string>("managerName"));
     assure(friends.manager, "Management entity not found");
 
@@ -382,7 +384,7 @@ BeaconLinkQualityMeasurementwithMIMO::doOnData(const wns::ldk::CompoundPtr& comp
         // this link-measurement frame is consumed here
         BeaconLinkQualityMeasurementwithMIMOCommand* blqm = getCommand(compound->getCommandPool());
         wifimac::convergence::PhyUserCommand* puc =
-            getFUN()->getCommandReader(phyUserCommandName)->readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool());
+            phyUserReader->readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool());
 
         if(!linkQualities.knows(friends.manager->getTransmitterAddress(compound->getCommandPool())))
         {
@@ -46,6 +46,7 @@
 #include <WNS/Observer.hpp>
 #include <WNS/distribution/Uniform.hpp>
 #include <WNS/SlidingWindow.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace draftn {
 
@@ -283,6 +284,7 @@ namespace wifimac { namespace draftn {
 
         /** @brief Name of PHY user commands to read the SINR */
         const std::string phyUserCommandName;
+        wns::ldk::CommandReaderInterface* phyUserReader;
 
         /** @brief Probing the power of received beacons */
         wns::probe::bus::ContextCollectorPtr receivedPower;
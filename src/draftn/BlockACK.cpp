@@ -30,6 +30,7 @@
 #include <WIFIMAC/convergence/PhyMode.hpp>
 
 #include <WNS/probe/bus/utils.hpp>
+#include <WNS/Exception.hpp>
 
 using namespace wifimac::draftn;
 
@@ -65,9 +66,12 @@ BlockACK::BlockACK(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& config_)
     maximumTransmissions(config_.get<size_t>("myConfig.maximumTransmissions")),
     impatientBAreqTransmission(config_.get<bool>("myConfig.impatient")),
     currentTxQueue(NULL),
-    rxQueues(),
-    hasACKfor(),
-    nextTransmissionSN(),
+    sessions(),
+    sessionIds(),
+    rxStorageSize(0),
+    pendingSessions(),
+    waitingStorageSize(0),
+    hasACKfor(-1),
     baState(idle),
 
     logger(config_.get("logger"))
@@ -88,6 +92,16 @@ BlockACK::BlockACK(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& config_)
 
     std::string pluginName = config_.get<std::string>("myConfig.sizeUnit");
     sizeCalculator = std::auto_ptr<wns::ldk::buffer::SizeCalculator>(wns::ldk::buffer::SizeCalculator::Factory::creator(pluginName)->create());
+
+    // the SNs on air must fit into the BlockACK window; for other size units,
+    // the TransmissionQueue limits the number of PDUs on air to the window
+    if((pluginName == "PDU") and (maxOnAir > static_cast<size_t>(BlockACKScoreboard::windowSize)))
+    {
+        wns::Exception e;
+        e << "maxOnAir of " << maxOnAir << " PDUs exceeds the BlockACK window of "
+          << BlockACKScoreboard::windowSize << " SNs";
+        throw wns::Exception(e);
+    }
 }
 
 BlockACK::BlockACK(const BlockACK& other) :
@@ -118,19 +132,70 @@ BlockACK::BlockACK(const BlockACK& other) :
     baReqBits(other.baReqBits),
     maximumTransmissions(other.maximumTransmissions),
     impatientBAreqTransmission(other.impatientBAreqTransmission),
+    currentTxQueue(NULL),
+    sessions(),
+    sessionIds(),
+    rxStorageSize(0),
+    pendingSessions(),
+    waitingStorageSize(0),
+    hasACKfor(-1),
     sizeCalculator(wns::clone(other.sizeCalculator))
 {
 }
 
 BlockACK::~BlockACK()
 {
-    // clear queues
-    rxQueues.clear();
-    if (currentTxQueue != NULL)
+    // clear queues, the currentTxQueue is one of the sessions' queues
+    for(std::vector<Session>::iterator it = sessions.begin();
+        it != sessions.end();
+        ++it)
+    {
+        delete it->txQueue;
+        delete it->rxQueue;
+    }
+    sessions.clear();
+    currentTxQueue = NULL;
+}
+
+int
+BlockACK::getSessionId(const wns::service::dll::UnicastAddress& peer)
+{
+    boost::unordered_map<int, int>::const_iterator it = sessionIds.find(peer.getInteger());
+    if(it != sessionIds.end())
     {
-       delete currentTxQueue;
-       currentTxQueue = NULL;
+        return(it->second);
     }
+
+    int id = sessions.size();
+    sessions.push_back(Session(peer));
+    sessionIds[peer.getInteger()] = id;
+    MESSAGE_SINGLE(NORMAL, this->logger, "New session " << id << " with " << peer);
+    return(id);
+}
+
+void
+BlockACK::startNextSession()
+{
+    assure(currentTxQueue == NULL, "current transmission queue has not finished");
+
+    if(pendingSessions.empty())
+    {
+        return;
+    }
+
+    Session& session = sessions[pendingSessions.front()];
+    pendingSessions.pop_front();
+    session.pending = false;
+
+    // the queue was not transmitting, so it holds only waiting compounds
+    waitingStorageSize -= session.txQueue->storageSize();
+    currentTxQueue = session.txQueue;
+
+    MESSAGE_BEGIN(NORMAL, this->logger, m, "Next round");
+    m << " for receiver: " << currentTxQueue->getReceiver();
+    m << " with SN: " << currentTxQueue->getNextSN();
+    m << ", " << currentTxQueue->getNumWaitingPDUs() << " frames waiting";
+    MESSAGE_END();
 }
 
 void BlockACK::onFUNCreated()
@@ -155,18 +220,12 @@ void BlockACK::onFUNCreated()
 unsigned int
 BlockACK::storageSize() const
 {
-    unsigned int size = 0;
+    // the rxQueues add their sizes to rxStorageSize
+    unsigned int size = this->rxStorageSize + this->waitingStorageSize;
 
     if (currentTxQueue != NULL)
     {
-        size = currentTxQueue->storageSize();
-    }
-
-    for(wns::container::Registry<wns::service::dll::UnicastAddress, ReceptionQueue*>::const_iterator it = rxQueues.begin();
-        it != rxQueues.end();
-        it++)
-    {
-        size += (*it).second->storageSize();
+        size += currentTxQueue->storageSize();
     }
 
     return(size);
@@ -176,9 +235,21 @@ BlockACK::storageSize() const
 bool
 BlockACK::doIsAccepting(const wns::ldk::CompoundPtr& compound) const
 {
-    return (((currentTxQueue == NULL) or
-             (currentTxQueue->getReceiver() == friends.manager->getReceiverAddress(compound->getCommandPool())))
-            and hasCapacity());
+    wns::service::dll::UnicastAddress receiver = friends.manager->getReceiverAddress(compound->getCommandPool());
+    if ((currentTxQueue == NULL) or (currentTxQueue->getReceiver() == receiver))
+    {
+        return(hasCapacity());
+    }
+
+    // compound waits in the queue of its receiver for the next round
+    if (this->storageSize() >= this->capacity)
+    {
+        return false;
+    }
+    boost::unordered_map<int, int>::const_iterator it = sessionIds.find(receiver.getInteger());
+    return((it == sessionIds.end()) or
+           (sessions[it->second].txQueue == NULL) or
+           (sessions[it->second].txQueue->storageSize() < this->maxOnAir));
 }
 
 
@@ -195,7 +266,7 @@ BlockACK::hasCapacity() const
 void
 BlockACK::processOutgoing(const wns::ldk::CompoundPtr& compound)
 {
-    assure(this->hasCapacity(), "processOutgoing although no capacity");
+    assure(this->doIsAccepting(compound), "processOutgoing although not accepting");
 
     if(friends.manager->lifetimeExpired(compound->getCommandPool()))
     {
@@ -210,25 +281,36 @@ BlockACK::processOutgoing(const wns::ldk::CompoundPtr& compound)
         MESSAGE_SINGLE(NORMAL, this->logger,"Next frame in a row  processed for receiver: " << currentTxQueue->getReceiver() << " with SN: " << currentTxQueue->getNextSN());
         currentTxQueue->processOutgoing(compound);
     }
-    if (currentTxQueue == NULL)
+    else
     {
-        if (not nextTransmissionSN.knows(receiver))
+        const int sessionId = getSessionId(receiver);
+        Session& session = sessions[sessionId];
+        if (session.txQueue == NULL)
         {
-            nextTransmissionSN.insert(receiver,0);
+            session.txQueue = new TransmissionQueue(this,
+                                                    maxOnAir,
+                                                    0.0,
+                                                    receiver,
+                                                    0,
+                                                    perMIB,
+                                                    &sizeCalculator);
+        }
+
+        MESSAGE_SINGLE(NORMAL, this->logger, "Frame for receiver " << receiver << " waits for its round with SN: " << session.txQueue->getNextSN());
+        const unsigned int queued = session.txQueue->storageSize();
+        session.txQueue->processOutgoing(compound);
+        waitingStorageSize += session.txQueue->storageSize() - queued;
+
+        if (not session.pending)
+        {
+            session.pending = true;
+            pendingSessions.push_back(sessionId);
+        }
+
+        if (currentTxQueue == NULL)
+        {
+            startNextSession();
         }
-        currentTxQueue = new TransmissionQueue(this,
-                                               maxOnAir,
-                                               0.0,
-                                               receiver,
-                                               nextTransmissionSN.find(receiver),
-                                               perMIB,
-                                               &sizeCalculator);
-
-        MESSAGE_BEGIN(NORMAL, this->logger, m, "First frame in a row");
-        m << " processed for receiver: " << currentTxQueue->getReceiver();
-        m << " with SN: " << nextTransmissionSN.find(receiver);
-        MESSAGE_END();
-        currentTxQueue->processOutgoing(compound);
     }
     MESSAGE_SINGLE(NORMAL, this->logger, "Stored outgoing frame, remaining capacity " << this->capacity - this->storageSize());
 }
@@ -253,37 +335,40 @@ BlockACK::processIncoming(const wns::ldk::CompoundPtr& compound)
     } // if compound is ACK
     else
     {
+        const int sessionId = getSessionId(transmitter);
+        Session& session = sessions[sessionId];
+
         if(getCommand(compound->getCommandPool())->isACKreq())
         {
-            if(not rxQueues.knows(transmitter))
+            if(session.rxQueue == NULL)
             {
                 MESSAGE_BEGIN(NORMAL, this->logger, m, "Received BA-REQ from unknown transmitter ");
                 m << transmitter << " (this would not happen with correct BA-init)";
                 m << " -> new rxQueue";
                 MESSAGE_END();
 
-                assure(not hasACKfor.isValid(), "Received BA-REQ from " << transmitter << ", but already existing BA for " << hasACKfor);
+                assure(hasACKfor == -1, "Received BA-REQ from " << transmitter << ", but already existing BA for " << sessions[hasACKfor].peer);
 
-                rxQueues.insert(transmitter, new ReceptionQueue(this, getCommand(compound->getCommandPool())->peer.sn, transmitter));
+                session.rxQueue = new ReceptionQueue(this, getCommand(compound->getCommandPool())->peer.sn, transmitter);
             }
-            rxQueues.find(transmitter)->processIncomingACKreq(compound);
-            hasACKfor = transmitter;
+            session.rxQueue->processIncomingACKreq(compound);
+            hasACKfor = sessionId;
             return;
         } // compound is ACK req
         else
         {
-            if(not rxQueues.knows(transmitter))
+            if(session.rxQueue == NULL)
             {
                 MESSAGE_SINGLE(NORMAL, this->logger, "First frame from " << transmitter << " -> new rxQueue");
-                rxQueues.insert(transmitter, new ReceptionQueue(this, getCommand(compound->getCommandPool())->peer.sn, transmitter));
+                session.rxQueue = new ReceptionQueue(this, getCommand(compound->getCommandPool())->peer.sn, transmitter);
             }
-            rxQueues.find(transmitter)->processIncomingData(compound, (*sizeCalculator)(compound));
+            session.rxQueue->processIncomingData(compound, (*sizeCalculator)(compound));
         } // is not ACK req
     } // is not ACK
 } // BlockACK::processIncoming
 
 void
-BlockACK::processIncomingACKSNs(std::set<BlockACKCommand::SequenceNumber> ackSNs)
+BlockACK::processIncomingACKSNs(const BlockACKScoreboard& ackSNs)
 {
     if(hasTimeoutSet())
     {
@@ -305,11 +390,13 @@ BlockACK::processIncomingACKSNs(std::set<BlockACKCommand::SequenceNumber> ackSNs
         return;
     }
 
-    // currentTxQueue is empty -> store SN and delete it
-    nextTransmissionSN.update(currentTxQueue->getReceiver(),currentTxQueue->getNextSN());
-    MESSAGE_SINGLE(NORMAL, this->logger, "No more waiting frames -> deleted currentTxQueue");
-    delete currentTxQueue;
+    // currentTxQueue is empty -> release it, the session keeps it together
+    // with the next SN
+    MESSAGE_SINGLE(NORMAL, this->logger, "No more waiting frames -> released currentTxQueue");
     currentTxQueue = NULL;
+
+    // continue with the next receiver which has waiting frames
+    startNextSession();
     return;
 }
 
@@ -317,9 +404,9 @@ BlockACK::processIncomingACKSNs(std::set<BlockACKCommand::SequenceNumber> ackSNs
 const wns::ldk::CompoundPtr
 BlockACK::hasACK() const
 {
-    if(hasACKfor.isValid())
+    if(hasACKfor != -1)
     {
-        return(rxQueues.find(hasACKfor)->hasACK());
+        return(sessions[hasACKfor].rxQueue->hasACK());
     }
     else
     {
@@ -330,9 +417,10 @@ BlockACK::hasACK() const
 wns::ldk::CompoundPtr
 BlockACK::getACK()
 {
-    wns::service::dll::UnicastAddress adr = hasACKfor;
-    hasACKfor = wns::service::dll::UnicastAddress();
-    return(rxQueues.find(adr)->getACK());
+    assure(hasACKfor != -1, "Called getACK although no ACK pending");
+    int sessionId = hasACKfor;
+    hasACKfor = -1;
+    return(sessions[sessionId].rxQueue->getACK());
 } // getACK
 
 const wns::ldk::CompoundPtr
@@ -411,9 +499,8 @@ BlockACK::onTimeout()
     MESSAGE_SINGLE(NORMAL, this->logger, "Timeout -> failed transmission to " << currentTxQueue->getReceiver());
     //perMIB->onFailedTransmission(currentTxQueue->getReceiver());
 
-    // no ACK'ed SNs have arrived, use pseudo-vector
-    std::set<BlockACKCommand::SequenceNumber> none;
-    none.clear();
+    // no ACK'ed SNs have arrived, use empty scoreboard
+    BlockACKScoreboard none;
     this->processIncomingACKSNs(none);
 
     this->tryToSend();
@@ -432,9 +519,8 @@ BlockACK::onTransmissionHasFailed(const wns::ldk::CompoundPtr& compound)
     //this->printTxQueueStatus();
 
 
-    // no ACK'ed SNs have arrived, use pseudo-vector
-    std::set<BlockACKCommand::SequenceNumber> none;
-    none.clear();
+    // no ACK'ed SNs have arrived, use empty scoreboard
+    BlockACKScoreboard none;
     this->processIncomingACKSNs(none);
 
     this->tryToSend();
@@ -49,6 +49,10 @@
 #include <WNS/Observer.hpp>
 #include <WNS/RoundRobin.hpp>
 
+#include <boost/unordered_map.hpp>
+#include <vector>
+#include <deque>
+
 #include <WIFIMAC/draftn/IBlockACKObserver.hpp>
 
 namespace wifimac {
@@ -92,10 +96,14 @@ namespace wifimac {
          * To handle outgoing and incoming compounds, the BlockACK uses the two
          * classes wifimac::draftN::TransmissionQueue  and
          * wifimac::draftN::ReceptionQueue:
-         * - A BlockACK FU has at most one current receiver peer node and for
-         *   this node one instance of wifimac::draftN::TransmissionQueue. This
-         *   queue contains all compounds which are intended for this receiver,
-         *   both not yet transmitted and on the air.
+         * - A BlockACK FU has one instance of
+         *   wifimac::draftN::TransmissionQueue for each receiver peer node. It
+         *   contains all compounds which are intended for this receiver, both
+         *   not yet transmitted and on the air. Only the queue of the current
+         *   receiver is transmitting, the compounds for the other receivers
+         *   wait in their queues. When the current queue has finished its
+         *   round, the next receiver with waiting compounds is served in
+         *   round-robin order.
          * - A BlockACK FU has multiple instances of
          *   wifimac::draftN::ReceptionQueue, one for each transmitter peer
          *   node. They are used to store out-of-order compounds and to generate
@@ -123,7 +131,28 @@ namespace wifimac {
             friend class TransmissionQueue;
             friend class ReceptionQueue;
 
-            typedef wns::container::Registry<wns::service::dll::UnicastAddress, BlockACKCommand::SequenceNumber> AddrSNMap;
+            /**
+             * @brief Queues of the BlockACK sessions with one peer node
+             *
+             * Both queues are created on first use and kept for the lifetime
+             * of the FU, hence the transmission queue keeps the SN for the
+             * next transmission round to this peer.
+             */
+            struct Session
+            {
+                Session(const wns::service::dll::UnicastAddress& peer_):
+                    peer(peer_),
+                    txQueue(NULL),
+                    rxQueue(NULL),
+                    pending(false)
+                    {}
+
+                wns::service::dll::UnicastAddress peer;
+                TransmissionQueue* txQueue;
+                ReceptionQueue* rxQueue;
+                /// the txQueue has compounds waiting for the next round
+                bool pending;
+            };
 
         public:
 
@@ -162,10 +191,10 @@ namespace wifimac {
             /**
              * @brief Processing of outgoing (to be transmitted) compounds
              *
-             * The BlockACK FU owns only one transmission queue which is
-             * operated on until all compounds are either successfully
-             * transmitted or discarded. Hence, if a compound for a different
-             * receiving peer node arrives, it is temporary stored until the
+             * Only the current transmission queue is operated on until all
+             * its compounds are either successfully transmitted or discarded.
+             * Hence, if a compound for a different receiving peer node
+             * arrives, it is stored in the queue of that peer until the
              * current txQueue has finished operation.
              *
              * As speciallity, the function tries to get as much frames as
@@ -179,14 +208,15 @@ namespace wifimac {
              * @brief Sets the conditions to accept a new compound to transmit
              *
              * These conditions are
-             * #- The storage capacity of the FU (size txQueue + sizes rxQueues)
-             *    is not exhausted.
-             * #- The last compound accepted has the same receiver as the
-             *    current transmission queue
-             * #- The transmission queue does not wait for an ACK, i.e. there
-             *    are no frames on the air.
-             * #- The number of frames in the txQueue is below the number which
-             *    can be send in the next round.
+             * #- The storage capacity of the FU (sizes txQueues + sizes
+             *    rxQueues) is not exhausted.
+             * #- The current transmission queue does not wait for an ACK, i.e.
+             *    there are no frames on the air.
+             * #- The number of frames in the current txQueue is below the
+             *    number which can be send in the next round.
+             *
+             * Compounds for other receivers are accepted by doIsAccepting
+             * as long as their own queue is below this number.
              */
             virtual bool
             hasCapacity() const;
@@ -293,7 +323,7 @@ namespace wifimac {
             /// Storage of outgoing, non-ack'ed frames
             TransmissionQueue *currentTxQueue;
 
-            /** @brief Compute storage size (txQueue + sum(rxQueues) */
+            /** @brief Compute storage size (sum(txQueues) + sum(rxQueues)) */
             virtual unsigned int
             storageSize() const;
 
@@ -334,7 +364,7 @@ namespace wifimac {
              * different receiver that has been stored temporarily)
              */
             virtual void
-            processIncomingACKSNs(std::set<BlockACKCommand::SequenceNumber> ackSNs);
+            processIncomingACKSNs(const BlockACKScoreboard& ackSNs);
 
     private:
 
@@ -344,6 +374,20 @@ namespace wifimac {
             /** @brief Debug helper function */
             void printTxQueueStatus() const;
 
+            /**
+             * @brief Dense index of the session with the peer in the
+             * sessions table, a new session is appended on first contact
+             */
+            int
+            getSessionId(const wns::service::dll::UnicastAddress& peer);
+
+            /**
+             * @brief Make the next session with waiting compounds the
+             * current one, in round-robin order
+             */
+            void
+            startNextSession();
+
             const std::string managerName;
             const std::string rxStartEndName;
             const std::string txStartEndName;
@@ -370,16 +414,23 @@ namespace wifimac {
             /// transmit as BAreq as early as possible without reaching maxOnAir
             const bool impatientBAreqTransmission;
 
-            /// Storage of incoming, non-ordered frames
-            wns::container::Registry<wns::service::dll::UnicastAddress, ReceptionQueue*> rxQueues;
+            /// Sessions with all known peers, indexed by session id
+            std::vector<Session> sessions;
+
+            /// Session id of each known peer, by address integer
+            boost::unordered_map<int, int> sessionIds;
+
+            /// Sum of the storage sizes of all rxQueues, maintained by them
+            unsigned int rxStorageSize;
+
+            /// Session ids with waiting compounds, in the order of their service
+            std::deque<int> pendingSessions;
 
-            /// indication that ACK must be transmitted
-            wns::service::dll::UnicastAddress hasACKfor;
+            /// Sum of the storage sizes of all txQueues except the current one
+            unsigned int waitingStorageSize;
 
-            /// mapping from unicast addresses to compound transmission SNs for
-            /// each link (receiver), the first SN of the next transmission
-            /// round is stored
-            AddrSNMap nextTransmissionSN;
+            /// Session id for which an ACK must be transmitted, -1 for none
+            int hasACKfor;
 
             struct Friends
             {
@@ -29,8 +29,9 @@
 #ifndef WIFIMAC_DRAFTN_BLOCKACKCOMMAND_HPP
 #define WIFIMAC_DRAFTN_BLOCKACKCOMMAND_HPP
 
+#include <WIFIMAC/draftn/BlockACKScoreboard.hpp>
+
 #include <WNS/ldk/arq/ARQ.hpp>
-#include <set>
 
 namespace wifimac {
     namespace draftn {
@@ -69,9 +70,9 @@ namespace wifimac {
                 SequenceNumber sn;
 
                 /**
-                 * @brief Set of sequence numbers in the BlockACK reply
+                 * @brief Bitmap of sequence numbers in the BlockACK reply
                  */
-                std::set<SequenceNumber> ackSNs;
+                BlockACKScoreboard ackSNs;
             } peer;
             struct {} magic;
 
@@ -0,0 +1,226 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/draftn/BlockACKScoreboard.hpp>
+
+#include <WNS/Assure.hpp>
+
+using namespace wifimac::draftn;
+
+const int BlockACKScoreboard::windowSize;
+
+BlockACKScoreboard::BlockACKScoreboard():
+    start(0)
+{
+    clear();
+} // BlockACKScoreboard
+
+bool
+BlockACKScoreboard::empty() const
+{
+    for(int i = 0; i < numWords; ++i)
+    {
+        if(words[i] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+} // BlockACKScoreboard::empty
+
+void
+BlockACKScoreboard::clear()
+{
+    for(int i = 0; i < numWords; ++i)
+    {
+        words[i] = 0;
+    }
+} // BlockACKScoreboard::clear
+
+int
+BlockACKScoreboard::count() const
+{
+    int n = 0;
+    for(int i = 0; i < numWords; ++i)
+    {
+        for(unsigned int w = words[i]; w != 0; w &= w - 1)
+        {
+            ++n;
+        }
+    }
+    return(n);
+} // BlockACKScoreboard::count
+
+void
+BlockACKScoreboard::insert(SequenceNumber sn)
+{
+    if(empty())
+    {
+        start = sn;
+    }
+    else if(sn < start)
+    {
+        if(last() - sn >= windowSize)
+        {
+            // older than the window ending at the largest SN
+            return;
+        }
+        moveStart(sn);
+    }
+    else if(sn - start >= windowSize)
+    {
+        if(sn - first() < windowSize)
+        {
+            moveStart(first());
+        }
+        else
+        {
+            // as in 802.11n, the window ends at the new SN and the SNs below
+            // its start fall out
+            moveStart(sn - windowSize + 1);
+        }
+    }
+
+    words[(sn - start) / bitsPerWord] |= (1u << ((sn - start) % bitsPerWord));
+} // BlockACKScoreboard::insert
+
+void
+BlockACKScoreboard::erase(SequenceNumber sn)
+{
+    if((sn >= start) and (sn - start < windowSize))
+    {
+        words[(sn - start) / bitsPerWord] &= ~(1u << ((sn - start) % bitsPerWord));
+    }
+} // BlockACKScoreboard::erase
+
+void
+BlockACKScoreboard::discardBefore(SequenceNumber sn)
+{
+    if(sn > start)
+    {
+        moveStart(sn);
+    }
+} // BlockACKScoreboard::discardBefore
+
+BlockACKScoreboard::SequenceNumber
+BlockACKScoreboard::first() const
+{
+    for(int i = 0; i < numWords; ++i)
+    {
+        if(words[i] != 0)
+        {
+            int bit = 0;
+            while(((words[i] >> bit) & 1u) == 0)
+            {
+                ++bit;
+            }
+            return(start + i * bitsPerWord + bit);
+        }
+    }
+    assure(false, "first() called on empty scoreboard");
+    return(start);
+} // BlockACKScoreboard::first
+
+BlockACKScoreboard::SequenceNumber
+BlockACKScoreboard::last() const
+{
+    for(int i = numWords - 1; i >= 0; --i)
+    {
+        if(words[i] != 0)
+        {
+            int bit = bitsPerWord - 1;
+            while(((words[i] >> bit) & 1u) == 0)
+            {
+                --bit;
+            }
+            return(start + i * bitsPerWord + bit);
+        }
+    }
+    assure(false, "last() called on empty scoreboard");
+    return(start);
+} // BlockACKScoreboard::last
+
+void
+BlockACKScoreboard::moveStart(SequenceNumber newStart)
+{
+    if(newStart > start)
+    {
+        // shift towards bit 0, the SNs below newStart fall out
+        SequenceNumber shift = newStart - start;
+        if(shift >= windowSize)
+        {
+            clear();
+        }
+        else
+        {
+            const int wordShift = shift / bitsPerWord;
+            const int bitShift = shift % bitsPerWord;
+            for(int i = 0; i < numWords; ++i)
+            {
+                unsigned int w = 0;
+                if(i + wordShift < numWords)
+                {
+                    w = words[i + wordShift] >> bitShift;
+                    if(bitShift != 0 and i + wordShift + 1 < numWords)
+                    {
+                        w |= words[i + wordShift + 1] << (bitsPerWord - bitShift);
+                    }
+                }
+                words[i] = w;
+            }
+        }
+    }
+    else if(newStart < start)
+    {
+        // shift away from bit 0, the SNs above the new window fall out
+        SequenceNumber shift = start - newStart;
+        if(shift >= windowSize)
+        {
+            clear();
+        }
+        else
+        {
+            const int wordShift = shift / bitsPerWord;
+            const int bitShift = shift % bitsPerWord;
+            for(int i = numWords - 1; i >= 0; --i)
+            {
+                unsigned int w = 0;
+                if(i - wordShift >= 0)
+                {
+                    w = words[i - wordShift] << bitShift;
+                    if(bitShift != 0 and i - wordShift - 1 >= 0)
+                    {
+                        w |= words[i - wordShift - 1] >> (bitsPerWord - bitShift);
+                    }
+                }
+                words[i] = w;
+            }
+        }
+    }
+    start = newStart;
+} // BlockACKScoreboard::moveStart
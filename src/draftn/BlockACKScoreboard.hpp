@@ -0,0 +1,129 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_DRAFTN_BLOCKACKSCOREBOARD_HPP
+#define WIFIMAC_DRAFTN_BLOCKACKSCOREBOARD_HPP
+
+#include <WNS/ldk/arq/ARQ.hpp>
+
+namespace wifimac {
+    namespace draftn {
+
+        /**
+         * @brief Fixed-size bitmap of sequence numbers, as in the compressed
+         * BlockACK of IEEE 802.11n
+         *
+         * The scoreboard stores a window of windowSize consecutive SNs,
+         * beginning at the start SN: Bit i is set if the SN start+i is
+         * contained. All operations work on a few machine words, no memory
+         * is allocated.
+         *
+         * The start SN follows the inserted SNs: It is set by the first
+         * insert into an empty scoreboard, moved if an SN outside of the
+         * window is inserted and moved up by discardBefore(). If an SN does
+         * not fit into the window together with the SNs already contained,
+         * the window slides as in 802.11n: A larger SN moves the window to end
+         * at it and the smaller SNs fall out, a smaller SN is ignored.
+         */
+        class BlockACKScoreboard
+        {
+        public:
+            typedef wns::ldk::arq::ARQCommand::SequenceNumber SequenceNumber;
+
+            /** @brief Number of SNs in the window */
+            static const int windowSize = 256;
+
+            BlockACKScoreboard();
+
+            bool
+            empty() const;
+
+            void
+            clear();
+
+            /** @brief Number of contained SNs */
+            int
+            count() const;
+
+            bool
+            contains(SequenceNumber sn) const
+                {
+                    return((sn >= start) and
+                           (sn - start < windowSize) and
+                           ((words[(sn - start) / bitsPerWord] >> ((sn - start) % bitsPerWord)) & 1u));
+                }
+
+            /**
+             * @brief Add the SN, slides the window if it does not fit
+             *
+             * SNs below sn-windowSize+1 are removed. An SN below
+             * last()-windowSize+1 is not added.
+             */
+            void
+            insert(SequenceNumber sn);
+
+            void
+            erase(SequenceNumber sn);
+
+            /** @brief Remove all SNs smaller than sn */
+            void
+            discardBefore(SequenceNumber sn);
+
+            /** @brief The smallest contained SN, must not be empty */
+            SequenceNumber
+            first() const;
+
+            /** @brief The largest contained SN, must not be empty */
+            SequenceNumber
+            last() const;
+
+            SequenceNumber
+            getStartSN() const
+                {
+                    return(start);
+                }
+
+        private:
+            static const int bitsPerWord = 32;
+            static const int numWords = windowSize / bitsPerWord;
+
+            /**
+             * @brief Move the window to begin at newStart, SNs which are not
+             * in the new window are removed
+             */
+            void
+            moveStart(SequenceNumber newStart);
+
+            SequenceNumber start;
+            unsigned int words[numWords];
+        };
+
+} // draftn
+} // wifimac
+
+#endif // WIFIMAC_DRAFTN_BLOCKACKSCOREBOARD_HPP
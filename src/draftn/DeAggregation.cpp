@@ -48,6 +48,7 @@ DeAggregation::DeAggregation(wns::ldk::fun::FUN* fun, const wns::pyconfig::View&
     protocolCalculatorName(config_.get<std::string>("protocolCalculatorName")),
     txStartEndName(config_.get<std::string>("phyUserName")),
     aggregationCommandName(config_.get<std::string>("aggregationCommandName")),
+    aggregationReader(NULL),
 
     txQueue(),
     currentTxCompound(),
@@ -71,6 +72,7 @@ DeAggregation::~DeAggregation()
 void DeAggregation::onFUNCreated()
 {
     MESSAGE_SINGLE(NORMAL, this->logger, "onFUNCreated() started");
+    aggregationReader = getFUN()->getCommandReader(aggregationCommandName);
     protocolCalculator = getFUN()->getLayer<dll::ILayer2*>()->getManagementService<wifimac::management::ProtocolCalculator>(protocolCalculatorName);
     friends.manager = getFUN()->findFriend<wifimac::lowerMAC::Manager*>(managerName);
 
@@ -112,7 +114,7 @@ DeAggregation::processIncoming(const wns::ldk::CompoundPtr& compound)
         friends.manager->setFrameType(this->currentRxContainer->getCommandPool(), DATA);
 
         // clear compound container
-        getFUN()->getCommandReader(aggregationCommandName)->
+        aggregationReader->
             readCommand<wns::ldk::concatenation::ConcatenationCommand>(this->currentRxContainer->getCommandPool())->peer.compounds.clear();
 
         MESSAGE_SINGLE(NORMAL, this->logger, "Received aggregation preamble, create container");
@@ -129,7 +131,7 @@ DeAggregation::processIncoming(const wns::ldk::CompoundPtr& compound)
            "Received A-MPDU fragment, but rxContainer is empty!");
 
     // append current compound
-    wns::ldk::concatenation::ConcatenationCommand* aggCommand = getFUN()->getCommandReader(aggregationCommandName)->
+    wns::ldk::concatenation::ConcatenationCommand* aggCommand = aggregationReader->
         readCommand<wns::ldk::concatenation::ConcatenationCommand>(this->currentRxContainer->getCommandPool());
     aggCommand->peer.compounds.push_back(compound);
 
@@ -139,8 +141,9 @@ DeAggregation::processIncoming(const wns::ldk::CompoundPtr& compound)
     if(command->peer.finalFragment)
     {
         MESSAGE_SINGLE(NORMAL, this->logger, "Received last aggregation fragment, deliver container with " << this->numEntries << " entries");
-        // final fragment -> deliver complete aggregated compound
-        wns::ldk::CompoundPtr it = this->currentRxContainer->copy();
+        // final fragment -> deliver complete aggregated compound; the
+        // container is handed over as nobody else holds it
+        wns::ldk::CompoundPtr it = this->currentRxContainer;
         this->currentRxContainer = wns::ldk::CompoundPtr();
         this->numEntries = 0;
         this->cancelTimeout();
@@ -181,7 +184,7 @@ DeAggregation::processOutgoing(const wns::ldk::CompoundPtr& compound)
     if(friends.manager->getFrameType(compound->getCommandPool()) == PREAMBLE)
     {
         command->local.txDuration = preambleTxDuration;
-        if(getFUN()->getCommandReader(aggregationCommandName)->commandIsActivated(compound->getCommandPool()))
+        if(aggregationReader->commandIsActivated(compound->getCommandPool()))
         {
             // preamble of aggregation command
             command->peer.singleFragment = false;
@@ -200,7 +203,7 @@ DeAggregation::processOutgoing(const wns::ldk::CompoundPtr& compound)
 
     wns::simulator::Time frameTxDuration = protocolCalculator->getDuration()->MPDU_PPDU(compound->getLengthInBits(), phyMode) - preambleTxDuration;
 
-    if(not getFUN()->getCommandReader(aggregationCommandName)->commandIsActivated(compound->getCommandPool()))
+    if(not aggregationReader->commandIsActivated(compound->getCommandPool()))
     {
         // not an aggregation container command, schedule transmission for now
         command->local.txDuration = frameTxDuration;
@@ -223,7 +226,7 @@ DeAggregation::processOutgoing(const wns::ldk::CompoundPtr& compound)
     // those of the Aggregation FU. HOWEVER since the frameTxDuration is correct and sizes are only used to calculate
     // fractions of this duration, the mechanism still works (-:
 
-    wns::ldk::concatenation::ConcatenationCommand* aggCommand = getFUN()->getCommandReader(aggregationCommandName)->
+    wns::ldk::concatenation::ConcatenationCommand* aggCommand = aggregationReader->
         readCommand<wns::ldk::concatenation::ConcatenationCommand>(compound->getCommandPool());
     for (std::vector<wns::ldk::CompoundPtr>::iterator it = aggCommand->peer.compounds.begin();
          it != aggCommand->peer.compounds.end();
@@ -40,6 +40,7 @@
 
 #include <WNS/events/CanTimeout.hpp>
 #include <WNS/Observer.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace draftn {
 
@@ -161,6 +162,7 @@ namespace wifimac { namespace draftn {
         const std::string protocolCalculatorName;
         const std::string txStartEndName;
         const std::string aggregationCommandName;
+        wns::ldk::CommandReaderInterface* aggregationReader;
 
         /** @brief Storage of outgoing fragments of a single aggregated compound */
         std::deque<wns::ldk::CompoundPtr> txQueue;
@@ -41,6 +41,7 @@ FastLinkFeedback::FastLinkFeedback(wns::ldk::fun::FUN* fun, const wns::pyconfig:
     wns::ldk::Processor<FastLinkFeedback>(),
 
     phyUserCommandName(config_.get<std::string>("phyUserCommandName")),
+    phyUserReader(NULL),
     managerName(config_.get<std::string>("managerName")),
     sinrMIBServiceName(config_.get<std::string>("sinrMIBServiceName")),
     estimatedValidity(config_.get<wns::simulator::Time>("myConfig.estimatedValidity")),
@@ -63,6 +64,7 @@ void FastLinkFeedback::onFUNCreated()
 {
     MESSAGE_SINGLE(NORMAL, this->logger, "onFUNCreated() started");
 
+    phyUserReader = getFUN()->getCommandReader(phyUserCommandName);
     friends.manager = getFUN()->findFriend<wifimac::lowerMAC::Manager*>(managerName);
     sinrMIB = getFUN()->getLayer<dll::Layer2*>()->getManagementService<wifimac::draftn::SINRwithMIMOInformationBase>(sinrMIBServiceName);
 }
@@ -74,7 +76,7 @@ void FastLinkFeedback::processIncoming(const wns::ldk::CompoundPtr& compound)
         if(getCommand(compound->getCommandPool())->peer.isRequest)
         {
             currentPeer = friends.manager->getTransmitterAddress(compound->getCommandPool());
-            wns::Ratio sinr = getFUN()->getCommandReader(phyUserCommandName)->
+            wns::Ratio sinr = phyUserReader->
                 readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool())->getCIRwithoutMIMO();
             sinrMIB->putMeasurement(currentPeer, sinr, estimatedValidity);
 
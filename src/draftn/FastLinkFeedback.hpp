@@ -37,6 +37,7 @@
 
 #include <WNS/pyconfig/View.hpp>
 #include <WNS/logger/Logger.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 namespace wifimac { namespace draftn {
 
@@ -74,6 +75,7 @@ namespace wifimac { namespace draftn {
 
         const std::string managerName;
         const std::string phyUserCommandName;
+        wns::ldk::CommandReaderInterface* phyUserReader;
         const std::string sinrMIBServiceName;
         const wns::simulator::Time estimatedValidity;
 
@@ -172,7 +172,7 @@ LongTrainingFieldGenerator::getSomethingToSend()
             wns::ldk::CompoundPtr ltf = this->pendingCompound->copy();
             friends.txDuration->getCommand(ltf->getCommandPool())->local.txDuration = ltfDuration;
             wifimac::convergence::PhyMode pm = friends.manager->getPhyMode(ltf->getCommandPool());
-            pm.setUniformMCS(pm.getSpatialStreams()[0], pm.getNumberOfSpatialStreams()+1);
+            pm.setUniformMCS(pm.getMCS(0), pm.getNumberOfSpatialStreams()+1);
             friends.manager->setPhyMode(ltf->getCommandPool(), pm);
             friends.manager->setFrameExchangeDuration(ltf->getCommandPool(),
                                                       friends.manager->getFrameExchangeDuration(ltf->getCommandPool())-ltfDuration);
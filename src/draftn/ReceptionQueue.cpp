@@ -35,27 +35,16 @@ ReceptionQueue::ReceptionQueue(BlockACK* parent_, BlockACKCommand::SequenceNumbe
     parent(parent_),
     adr(adr_),
     waitingForSN(firstSN_),
-    rxStorage(),
+    rxStorage(BlockACKScoreboard::windowSize),
+    storedSNs(),
+    numStored(0),
+    storedSize(0),
     rxSNs(),
     blockACK()
 {
     MESSAGE_SINGLE(NORMAL, parent->logger, "RxQ" << adr << " created");
 } // ReceptionQueue
 
-const unsigned int
-ReceptionQueue::storageSize() const
-{
-    unsigned int size = 0;
-
-    for(std::map<BlockACKCommand::SequenceNumber, CompoundPtrWithSize>::const_iterator it = rxStorage.begin();
-        it != rxStorage.end();
-        it++)
-    {
-        size += it->second.second;
-    }
-    return(size);
-} // ReceptionQueue::size
-
 void
 ReceptionQueue::processIncomingData(const wns::ldk::CompoundPtr& compound, const unsigned int size)
 {
@@ -67,6 +56,16 @@ ReceptionQueue::processIncomingData(const wns::ldk::CompoundPtr& compound, const
     // store sn for ack
     rxSNs.insert(baCommand->peer.sn);
 
+    // The storage holds the SNs below waitingForSN+windowSize. As in 802.11n,
+    // a newer SN moves the window to end at it: The stored compounds below
+    // the new start are delivered, the missing ones are given up.
+    if((baCommand->peer.sn > this->waitingForSN) and
+       (baCommand->peer.sn - this->waitingForSN >= BlockACKScoreboard::windowSize))
+    {
+        MESSAGE_SINGLE(NORMAL, parent->logger, "RxQ" << adr << ": Received SN " << baCommand->peer.sn << " beyond the window");
+        this->flushBefore(baCommand->peer.sn - BlockACKScoreboard::windowSize + 1);
+    }
+
     // process data compound
     if(baCommand->peer.sn == this->waitingForSN)
     {
@@ -85,7 +84,7 @@ ReceptionQueue::processIncomingData(const wns::ldk::CompoundPtr& compound, const
     {
         // received compound does not match waitingForSN
 
-        if((baCommand->peer.sn < this->waitingForSN) or (rxStorage.find(baCommand->peer.sn) != rxStorage.end()))
+        if((baCommand->peer.sn < this->waitingForSN) or (storedSNs.contains(baCommand->peer.sn)))
         {
             // received old compound
             MESSAGE_BEGIN(NORMAL, parent->logger, m, "RxQ" << adr << ": Received known SN ");
@@ -102,7 +101,13 @@ ReceptionQueue::processIncomingData(const wns::ldk::CompoundPtr& compound, const
             m << ", waiting for " << this->waitingForSN;
             m << " --> store";
             MESSAGE_END();
-            rxStorage[baCommand->peer.sn] = CompoundPtrWithSize(compound, size);
+            assure(baCommand->peer.sn - this->waitingForSN < BlockACKScoreboard::windowSize,
+                   "SN " << baCommand->peer.sn << " is outside of the reception window");
+            storedSNs.insert(baCommand->peer.sn);
+            slot(baCommand->peer.sn) = CompoundPtrWithSize(compound, size);
+            ++numStored;
+            storedSize += size;
+            parent->rxStorageSize += size;
         }
     }
 
@@ -111,27 +116,48 @@ ReceptionQueue::processIncomingData(const wns::ldk::CompoundPtr& compound, const
 void
 ReceptionQueue::purgeRxStorage()
 {
-   while(not rxStorage.empty())
+   // stop at the first gap
+   while(storedSNs.contains(this->waitingForSN))
    {
-       if(rxStorage.begin()->first == this->waitingForSN)
-       {
-           MESSAGE_BEGIN(NORMAL, parent->logger, m, "RxQ" << adr << ": New SN allows in-order delivery SN ");
-           m << this->waitingForSN;
-           m << " --> deliver";
-           MESSAGE_END();
-
-           parent->getDeliverer()->getAcceptor(rxStorage.begin()->second.first)->onData(rxStorage.begin()->second.first);
-           rxStorage.erase(rxStorage.begin());
-           ++this->waitingForSN;
-       }
-       else
-       {
-           // gap still exists
-           return;
-       }
+       MESSAGE_BEGIN(NORMAL, parent->logger, m, "RxQ" << adr << ": New SN allows in-order delivery SN ");
+       m << this->waitingForSN;
+       m << " --> deliver";
+       MESSAGE_END();
+
+       deliverStored(this->waitingForSN);
+       ++this->waitingForSN;
    }
 } // ReceptionQueue::purgeRxStorage
 
+void
+ReceptionQueue::flushBefore(BlockACKCommand::SequenceNumber sn)
+{
+    // stop waiting for everything below the sn
+    while((not storedSNs.empty()) and (storedSNs.first() < sn))
+    {
+        MESSAGE_SINGLE(NORMAL, parent->logger, "RxQ" << adr << ": Stop waiting below SN " << sn << " -> deliver waiting SN " << storedSNs.first());
+        deliverStored(storedSNs.first());
+    }
+    // waitingForSN is never reduced
+    this->waitingForSN = (sn > this->waitingForSN) ? (sn) : (this->waitingForSN);
+    // shift of waitingForSN might free already received frames
+    this->purgeRxStorage();
+} // ReceptionQueue::flushBefore
+
+void
+ReceptionQueue::deliverStored(BlockACKCommand::SequenceNumber sn)
+{
+    // release the slot before the delivery
+    CompoundPtrWithSize stored = slot(sn);
+    slot(sn) = CompoundPtrWithSize();
+    storedSNs.erase(sn);
+    --numStored;
+    storedSize -= stored.second;
+    parent->rxStorageSize -= stored.second;
+
+    parent->getDeliverer()->getAcceptor(stored.first)->onData(stored.first);
+} // ReceptionQueue::deliverStored
+
 void
 ReceptionQueue::processIncomingACKreq(const wns::ldk::CompoundPtr& compound)
 {
@@ -141,23 +167,10 @@ ReceptionQueue::processIncomingACKreq(const wns::ldk::CompoundPtr& compound)
     // frames before that sn are discarded due to maximum lifetime or
     // retransmissions
     BlockACKCommand::SequenceNumber minSN = parent->getCommand(compound->getCommandPool())->peer.sn;
-    // stop waiting for everything below the minSN
-    while((not rxStorage.empty()) and (rxStorage.begin()->first < minSN))
-    {
-        MESSAGE_SINGLE(NORMAL, parent->logger, "RxQ" << adr << ": Received BAreq with SN " << minSN << " -> deliver waiting SN " << rxStorage.begin()->first);
-        parent->getDeliverer()->getAcceptor(rxStorage.begin()->second.first)->onData(rxStorage.begin()->second.first);
-        rxStorage.erase(rxStorage.begin());
-    }
-    // waitingForSN is never reduced
-    this->waitingForSN = (minSN > this->waitingForSN) ? (minSN) : (this->waitingForSN);
-    // shift of waitingForSN might free already received frames
-    this->purgeRxStorage();
+    this->flushBefore(minSN);
 
     // do not acknowledge old frames
-    while((not rxSNs.empty()) and (*(rxSNs.begin()) < minSN))
-    {
-        rxSNs.erase(rxSNs.begin());
-    }
+    rxSNs.discardBefore(minSN);
 
     // create BlockACK
     wns::simulator::Time fxDur = parent->friends.manager->getFrameExchangeDuration(compound->getCommandPool()) - parent->sifsDuration - parent->maximumACKDuration;
@@ -186,7 +199,7 @@ ReceptionQueue::processIncomingACKreq(const wns::ldk::CompoundPtr& compound)
     else
     {
         // take the minimum of waiting for and rxSNs
-        baCommand->peer.sn = (*(rxSNs.begin())) < this->waitingForSN ? (*(rxSNs.begin())) : this->waitingForSN;
+        baCommand->peer.sn = rxSNs.first() < this->waitingForSN ? rxSNs.first() : this->waitingForSN;
     }
 
     MESSAGE_BEGIN(NORMAL, parent->logger, m, "RxQ" << adr << ": Received BAreq with SN ");
@@ -196,11 +209,15 @@ ReceptionQueue::processIncomingACKreq(const wns::ldk::CompoundPtr& compound)
     m << " startSN: " << baCommand->peer.sn;
     m << " ackSNs:";
 #ifndef WNS_NO_LOGGING
-    for(std::set<BlockACKCommand::SequenceNumber>::iterator snIt = rxSNs.begin();
-        snIt != rxSNs.end();
-        snIt++)
+    if(not rxSNs.empty())
     {
-        m << " " << (*snIt);
+        for(BlockACKCommand::SequenceNumber sn = rxSNs.first(); sn <= rxSNs.last(); ++sn)
+        {
+            if(rxSNs.contains(sn))
+            {
+                m << " " << sn;
+            }
+        }
     }
 #endif
     MESSAGE_END();
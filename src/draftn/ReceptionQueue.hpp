@@ -30,10 +30,13 @@
 #define WIFIMAC_DRAFTN_RECEPTIONQUEUE_HPP
 
 #include <WIFIMAC/draftn/BlockACKCommand.hpp>
+#include <WIFIMAC/draftn/BlockACKScoreboard.hpp>
 
 #include <WNS/ldk/Compound.hpp>
 #include <WNS/service/dll/Address.hpp>
 
+#include <vector>
+
 namespace wifimac {
     namespace draftn {
 
@@ -51,6 +54,14 @@ namespace wifimac {
          *
          * Hence, the reception queue implements the receiver functions of the
          * BlockACK FU: processIncoming[Data|ACK] and [has|get]ACK
+         *
+         * Both the received SNs for the next BlockACK reply and the SNs of the
+         * stored compounds are kept in BlockACKScoreboards. The stored
+         * compounds are placed in a ring of BlockACKScoreboard::windowSize
+         * slots, indexed by their SN. Only SNs below
+         * waitingForSN+BlockACKScoreboard::windowSize are stored, a larger SN
+         * first moves waitingForSN up (see processIncomingData), so that no
+         * two stored compounds share a slot.
          */
 
         class ReceptionQueue
@@ -76,6 +87,11 @@ namespace wifimac {
              * the compound has to be stored until they are received
              * successfully (SN > waitingSN). In both cases, the SN is added to
              * the set of received SNs for the next BlockACK reply.
+             *
+             * An SN at or beyond waitingSN+BlockACKScoreboard::windowSize
+             * moves the reception window as in 802.11n: The stored compounds
+             * below SN-windowSize+1 are delivered and the missing ones are not
+             * waited for any more.
              */
             void
             processIncomingData(const wns::ldk::CompoundPtr& compound,
@@ -103,17 +119,37 @@ namespace wifimac {
             wns::ldk::CompoundPtr getACK();
 
             const size_t numPDUs() const
-                { return rxStorage.size(); }
-            const unsigned int storageSize() const;
+                { return numStored; }
+            const unsigned int storageSize() const
+                { return storedSize; }
 
         private:
             void purgeRxStorage();
 
-            const BlockACK* parent;
+            /**
+             * @brief Deliver the stored compounds below sn and wait at least
+             * for sn
+             */
+            void flushBefore(BlockACKCommand::SequenceNumber sn);
+
+            /** @brief Deliver the stored compound and remove it from the storage */
+            void deliverStored(BlockACKCommand::SequenceNumber sn);
+
+            CompoundPtrWithSize&
+            slot(BlockACKCommand::SequenceNumber sn)
+                { return rxStorage[sn % BlockACKScoreboard::windowSize]; }
+
+            BlockACK* parent;
             const wns::service::dll::UnicastAddress adr;
             BlockACKCommand::SequenceNumber waitingForSN;
-            std::map<BlockACKCommand::SequenceNumber, CompoundPtrWithSize> rxStorage;
-            std::set<BlockACKCommand::SequenceNumber> rxSNs;
+            /** @brief Compounds waiting for in-order delivery, see slot() */
+            std::vector<CompoundPtrWithSize> rxStorage;
+            /** @brief SNs of the compounds in the rxStorage */
+            BlockACKScoreboard storedSNs;
+            size_t numStored;
+            unsigned int storedSize;
+            /** @brief SNs received since the last BlockACK reply */
+            BlockACKScoreboard rxSNs;
             wns::ldk::CompoundPtr blockACK;
         };
 
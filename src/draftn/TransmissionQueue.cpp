@@ -45,6 +45,8 @@ TransmissionQueue::TransmissionQueue(BlockACK* parent_,
     adr(adr_),
     txQueue(),
     onAirQueue(),
+    txSize(0),
+    onAirSize(0),
     nextSN(sn_),
     baREQ(),
     waitForACK(false),
@@ -75,33 +77,6 @@ TransmissionQueue::~TransmissionQueue()
 } // TransmissionQueue::~TransmissionQueue
 
 
-const unsigned int
-TransmissionQueue::onAirQueueSize() const
-{
-    unsigned int size = 0;
-    for(std::deque<CompoundPtrWithTime>::const_iterator it = onAirQueue.begin();
-        it != onAirQueue.end();
-        it++)
-    {
-        size += (*(*sizeCalculator))(it->first);
-    }
-    return(size);
-}
-
-const unsigned int
-TransmissionQueue::txQueueSize() const
-{
-    unsigned int size = 0;
-    for(std::deque<CompoundPtrWithTime>::const_iterator it = txQueue.begin();
-        it != txQueue.end();
-        it++)
-    {
-       size += (*(*sizeCalculator))(it->first);
-    }
-    return(size);
-}
-
-
 const unsigned int
 TransmissionQueue::storageSize() const
 {
@@ -118,7 +93,10 @@ TransmissionQueue::processOutgoing(const wns::ldk::CompoundPtr& compound)
 
     MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": Queue outgoing compound with sn " << baCommand->peer.sn);
     MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": send time for compound is " << wns::simulator::getEventScheduler()->getTime()+this->maxDelay << " maxDelay is " << this->maxDelay << " oldest is " << oldestTimestamp);
-    txQueue.push_back(CompoundPtrWithTime(compound, wns::simulator::getEventScheduler()->getTime()));
+    txQueue.push_back(QueuedCompound(compound,
+                                     wns::simulator::getEventScheduler()->getTime(),
+                                     (*(*sizeCalculator))(compound)));
+    txSize += txQueue.back().size;
 
     if ((oldestTimestamp == wns::simulator::Time()) or
         (wns::simulator::getEventScheduler()->getTime() < oldestTimestamp))
@@ -127,6 +105,16 @@ TransmissionQueue::processOutgoing(const wns::ldk::CompoundPtr& compound)
     }
 } // TransmissionQueue::processOutgoing
 
+bool
+TransmissionQueue::frontFitsOnAir() const
+{
+    // the BlockACK window limits the number of PDUs on air, also if maxOnAir
+    // is not given in PDUs
+    return((not txQueue.empty()) and
+           (onAirSize + txQueue.front().size <= this->maxOnAir) and
+           (onAirQueue.size() < static_cast<size_t>(BlockACKScoreboard::windowSize)));
+} // TransmissionQueue::frontFitsOnAir
+
 const
 wns::ldk::CompoundPtr TransmissionQueue::hasData() const
 {
@@ -136,11 +124,11 @@ wns::ldk::CompoundPtr TransmissionQueue::hasData() const
         // no other transmissions during waiting for ACK
         return(wns::ldk::CompoundPtr());
     }
-    if((not txQueue.empty()) and (onAirQueueSize()+(*(*sizeCalculator))(txQueue.front().first) <= this->maxOnAir))
+    if(frontFitsOnAir())
     {
         // regular frame pending
         MESSAGE_SINGLE(VERBOSE, parent->logger, "TxQ" << adr << ": hasData: Regular frame is pending");
-        return(txQueue.front().first);
+        return(txQueue.front().compound);
     }
 
     // baReq pending
@@ -154,14 +142,15 @@ wns::ldk::CompoundPtr TransmissionQueue::hasData() const
 
         // next compound would exceed on air limit -> send
         if((not txQueue.empty()) and
-           (onAirQueueSize()+(*(*sizeCalculator))(txQueue.front().first) > this->maxOnAir))
+           (not frontFitsOnAir()))
         {
             return(this->baREQ);
         }
 
         // no next compound, but nothing would match anyway -> send
         if((txQueue.empty()) and
-           (onAirQueueSize() == this->maxOnAir))
+           ((onAirSize == this->maxOnAir) or
+            (onAirQueue.size() == static_cast<size_t>(BlockACKScoreboard::windowSize))))
         {
             return(this->baREQ);
         }
@@ -177,12 +166,13 @@ TransmissionQueue::getData()
     assure(this->hasData(), "Called getData although hasData is false");
 
     // compound pending?
-    if((not txQueue.empty()) and
-       (onAirQueueSize()+(*(*sizeCalculator))(txQueue.front().first) <= this->maxOnAir))
+    if(frontFitsOnAir())
     {
         // transmit another frame
         onAirQueue.push_back(txQueue.front());
-        wns::ldk::CompoundPtr it = txQueue.front().first;
+        onAirSize += txQueue.front().size;
+        txSize -= txQueue.front().size;
+        wns::ldk::CompoundPtr it = txQueue.front().compound;
         txQueue.pop_front();
 
         MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": Transmit pending frame with sn " << parent->getCommand(it->getCommandPool())->peer.sn);
@@ -196,20 +186,20 @@ TransmissionQueue::getData()
            "No compound pending and no baReqRequired, but hasData is true");
     if(txQueue.empty())
     {
-        MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": No more frames to tx, send BAreq with start-sn " << parent->getCommand(onAirQueue.front().first)->peer.sn);
+        MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": No more frames to tx, send BAreq with start-sn " << parent->getCommand(onAirQueue.front().compound)->peer.sn);
         oldestTimestamp = wns::simulator::Time();
     }
     else
     {
-        MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": Reached tx window, send BAreq with start-sn " << parent->getCommand(onAirQueue.front().first)->peer.sn);
-        oldestTimestamp = txQueue.front().second;
+        MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": Reached tx window, send BAreq with start-sn " << parent->getCommand(onAirQueue.front().compound)->peer.sn);
+        oldestTimestamp = txQueue.front().timestamp;
     }
 
     wns::ldk::CompoundPtr it = this->baREQ->copy();
     // no more BAreq required until next regular frame transmission
     this->baReqRequired = false;
     // now set start-sn of BA-req to sn of first compound in transmission queue
-    parent->getCommand(it->getCommandPool())->peer.sn = parent->getCommand(onAirQueue.front().first)->peer.sn;
+    parent->getCommand(it->getCommandPool())->peer.sn = parent->getCommand(onAirQueue.front().compound)->peer.sn;
     // stop future transmissions until ACK (or timeout of it) arrives
     this->waitForACK = true;
     MESSAGE_SINGLE(NORMAL, parent->logger, "TxQ" << adr << ": Set waitForACK to true");
@@ -218,7 +208,7 @@ TransmissionQueue::getData()
 } // TransmissionQueue::getData
 
 void
-TransmissionQueue::processIncomingACK(std::set<BlockACKCommand::SequenceNumber> ackSNs)
+TransmissionQueue::processIncomingACK(const BlockACKScoreboard& ackSNs)
 {
     assure(not onAirQueue.empty(), "Received ACK but onAirQueue is empy");
     assure(this->waitForACK, "Received ACK but not waiting for one");
@@ -227,7 +217,7 @@ TransmissionQueue::processIncomingACK(std::set<BlockACKCommand::SequenceNumber>
 
     bool insertBack = false;
     bool blockACKsuccess = true;
-    std::deque<CompoundPtrWithTime>::iterator txQueueFirst;
+    std::deque<QueuedCompound>::iterator txQueueFirst;
     unsigned long transmittedBits =0;
 
     if(txQueue.empty())
@@ -239,37 +229,36 @@ TransmissionQueue::processIncomingACK(std::set<BlockACKCommand::SequenceNumber>
         txQueueFirst = txQueue.begin();
     }
 
-    std::set<wifimac::draftn::BlockACKCommand::SequenceNumber>::iterator snIt = ackSNs.begin();
     assure(isSortedBySN(onAirQueue),
            "onAirQueue is not sorted by SN!");
 
-    for(std::deque<CompoundPtrWithTime>::iterator onAirIt = onAirQueue.begin();
+    for(std::deque<QueuedCompound>::iterator onAirIt = onAirQueue.begin();
         onAirIt != onAirQueue.end();
         onAirIt++)
     {
-        wifimac::draftn::BlockACKCommand::SequenceNumber onAirSN = parent->getCommand((onAirIt->first)->getCommandPool())->peer.sn;
+        wifimac::draftn::BlockACKCommand::SequenceNumber onAirSN = parent->getCommand((onAirIt->compound)->getCommandPool())->peer.sn;
 
-        if((snIt == ackSNs.end()) or (*snIt != onAirSN))
+        if(not ackSNs.contains(onAirSN))
         {
              // retransmission
-            int txCounter = ++(parent->getCommand((onAirIt->first)->getCommandPool())->localTransmissionCounter);
+            int txCounter = ++(parent->getCommand((onAirIt->compound)->getCommandPool())->localTransmissionCounter);
             blockACKsuccess = false;
-            if(parent->getManager()->lifetimeExpired((onAirIt->first)->getCommandPool()))
+            if(parent->getManager()->lifetimeExpired((onAirIt->compound)->getCommandPool()))
             {
                 MESSAGE_BEGIN(NORMAL, parent->logger, m, "TxQ" << adr << ":   Compound " << onAirSN);
-                m << ", ackSN " << ((snIt == ackSNs.end()) ? -1 : (*snIt));
+                m << " not acknowledged";
                 m << " -> " << txCounter;
                 m << " transmissions, lifetime expired --> drop!";
                 MESSAGE_END();
 
-                parent->numTxAttemptsProbe->put(onAirIt->first, txCounter);
+                parent->numTxAttemptsProbe->put(onAirIt->compound, txCounter);
             } // lifetime expired
             else
             {
                 // BlockACK does not drop frames due to their number of
                 // retransmissions, see IEEE 802.11-2007, 9.10.3
                 MESSAGE_BEGIN(NORMAL, parent->logger, m, "TxQ" << adr << ":   Compound " << onAirSN);
-                m << ", ackSN " << ((snIt == ackSNs.end()) ? -1 : (*snIt));
+                m << " not acknowledged";
                 m << " -> " << txCounter;
                 m << " transmissions, retransmit";
                 MESSAGE_END();
@@ -283,18 +272,18 @@ TransmissionQueue::processIncomingACK(std::set<BlockACKCommand::SequenceNumber>
                     txQueueFirst = txQueue.insert(txQueueFirst, *onAirIt);
                     txQueueFirst++;
                 }
+                txSize += onAirIt->size;
             } // lifetime not expired
         } // SN does not match
         else
         {
-            // *snIt is equal to sn from *onAirIt --> success, go to next sn
+            // sn from *onAirIt is acknowledged --> success
             MESSAGE_BEGIN(NORMAL, parent->logger, m, "TxQ" << adr << ":   Compound " << onAirSN);
-            m << ", ackSN " << (*snIt) << " -> success";
+            m << " acknowledged -> success";
             MESSAGE_END();
-            snIt++;
 
-            parent->numTxAttemptsProbe->put(onAirIt->first, parent->getCommand((onAirIt->first)->getCommandPool())->localTransmissionCounter);
-            transmittedBits+=(onAirIt->first)->getCommandPool()->getSDU()->getLengthInBits();
+            parent->numTxAttemptsProbe->put(onAirIt->compound, parent->getCommand((onAirIt->compound)->getCommandPool())->localTransmissionCounter);
+            transmittedBits+=(onAirIt->compound)->getCommandPool()->getSDU()->getLengthInBits();
         } // SN matches
     } // for-loop over onAirQueue
 
@@ -314,31 +303,25 @@ TransmissionQueue::processIncomingACK(std::set<BlockACKCommand::SequenceNumber>
         parent->observers[i]->onBlockACKReception(blockACKsuccess,transmittedBits);
     }
     onAirQueue.clear();
+    onAirSize = 0;
 
-   // find oldest timestamp
-   oldestTimestamp = wns::simulator::Time();
-   if (txQueueSize() > 0)
-   {
-       oldestTimestamp = txQueue.begin()->second;
-       for (std::deque<CompoundPtrWithTime>::iterator itr = txQueue.begin(); itr != txQueue.end(); itr++)
-       {
-           if (itr->second < oldestTimestamp)
-           {
-               oldestTimestamp = itr->second;
-           }
-       }
-   }
+    // the txQueue is ordered by time, the oldest compound is at its head
+    oldestTimestamp = wns::simulator::Time();
+    if (not txQueue.empty())
+    {
+        oldestTimestamp = txQueue.front().timestamp;
+    }
 } // TransmissionQueue::processACK
 
 bool
-TransmissionQueue::isSortedBySN(const std::deque<CompoundPtrWithTime> q) const
+TransmissionQueue::isSortedBySN(const std::deque<QueuedCompound>& q) const
 {
     if(q.empty())
     {
         return true;
     }
-    std::deque<CompoundPtrWithTime>::const_iterator it = q.begin();
-    wifimac::draftn::BlockACKCommand::SequenceNumber lastSN = parent->getCommand((it->first)->getCommandPool())->peer.sn;
+    std::deque<QueuedCompound>::const_iterator it = q.begin();
+    wifimac::draftn::BlockACKCommand::SequenceNumber lastSN = parent->getCommand((it->compound)->getCommandPool())->peer.sn;
     ++it;
     MESSAGE_SINGLE(NORMAL,parent->logger,"SN: (+)" << lastSN);
 
@@ -346,7 +329,7 @@ TransmissionQueue::isSortedBySN(const std::deque<CompoundPtrWithTime> q) const
         it != q.end();
         it++)
     {
-        wifimac::draftn::BlockACKCommand::SequenceNumber curSN = parent->getCommand((it->first)->getCommandPool())->peer.sn;
+        wifimac::draftn::BlockACKCommand::SequenceNumber curSN = parent->getCommand((it->compound)->getCommandPool())->peer.sn;
         MESSAGE_SINGLE(NORMAL,parent->logger,"SN: " << curSN);
         if(curSN < lastSN)
         {
@@ -370,7 +353,7 @@ TransmissionQueue::getTxFront()
 	{
 		return wns::ldk::CompoundPtr();
 	}
-	return txQueue.front().first;
+	return txQueue.front().compound;
 }
 
 
@@ -379,14 +362,15 @@ TransmissionQueue::getAirableCompounds()
 {
     std::list<wns::ldk::CompoundPtr> ret;
     size_t retSize = 0;
-    for (std::deque<CompoundPtrWithTime>::iterator itr = txQueue.begin(); itr != txQueue.end(); itr++)
+    for (std::deque<QueuedCompound>::iterator itr = txQueue.begin(); itr != txQueue.end(); itr++)
     {
-        if (retSize + (*(*sizeCalculator))(itr->first) > maxOnAir)
+        if ((retSize + itr->size > maxOnAir) or
+            (ret.size() >= static_cast<size_t>(BlockACKScoreboard::windowSize)))
         {
             break;
         }
-        ret.push_back(itr->first);
-        retSize += (*(*sizeCalculator))(itr->first);
+        ret.push_back(itr->compound);
+        retSize += itr->size;
     }
     return ret;
 }
@@ -52,15 +52,35 @@ namespace wifimac {
          * Two queues are inside the transmission queue: One for the compounds
          * waiting to be transmitted (txQueue), and the other for compounds already
          * transmitted, but not acknowledged (onAirQueue). The onAirQueue cannot
-         * exceed the maxOnAir limitation.
+         * exceed the maxOnAir limitation, nor hold more than
+         * BlockACKScoreboard::windowSize compounds.
+         *
+         * The size of each compound is computed once when it is queued, the
+         * sizes of both queues are kept as running sums. The txQueue is always
+         * ordered by the queueing time, as retransmissions are inserted at its
+         * head in the order of their first transmission.
          */
         class TransmissionQueue
         {
 
             /**
-             * @brief Store each compound together with its expiration time
+             * @brief Store each compound together with its queueing time and
+             * its size
              */
-            typedef std::pair<wns::ldk::CompoundPtr, wns::simulator::Time> CompoundPtrWithTime;
+            struct QueuedCompound
+            {
+                QueuedCompound(const wns::ldk::CompoundPtr& compound_,
+                               const wns::simulator::Time timestamp_,
+                               const unsigned int size_):
+                    compound(compound_),
+                    timestamp(timestamp_),
+                    size(size_)
+                    {}
+
+                wns::ldk::CompoundPtr compound;
+                wns::simulator::Time timestamp;
+                unsigned int size;
+            };
 
         public:
             TransmissionQueue(BlockACK* parent_,
@@ -98,16 +118,14 @@ namespace wifimac {
             getData();
 
             /**
-             * @brief Iterate, using two iterators, over the onAirQueue and the
-             *        SNs indicated in the ACK to identify packet losses.
+             * @brief Iterate over the onAirQueue and look up each SN in the
+             *        bitmap of the ACK to identify packet losses.
              *
-             * Two iterators are used to identify packet losses: One for the
-             * onAirQueue and the other on for the SNs in the received
-             * ACK. Frames are re-transmitted (by insertion at the head of the
+             * Frames are re-transmitted (by insertion at the head of the
              * txQueue) until their lifetime is exceeded.
              */
             void
-            processIncomingACK(std::set<BlockACKCommand::SequenceNumber> ackSNs);
+            processIncomingACK(const BlockACKScoreboard& ackSNs);
 
             const size_t getNumOnAirPDUs() const
                 { return onAirQueue.size(); }
@@ -116,10 +134,12 @@ namespace wifimac {
                 { return txQueue.size(); }
 
             const unsigned int
-            onAirQueueSize() const;
+            onAirQueueSize() const
+                { return onAirSize; }
 
             const unsigned int
-            txQueueSize() const;
+            txQueueSize() const
+                { return txSize; }
 
             const unsigned int
             storageSize() const;
@@ -171,7 +191,14 @@ namespace wifimac {
 
         private:
             bool
-            isSortedBySN(const std::deque<CompoundPtrWithTime> q) const;
+            isSortedBySN(const std::deque<QueuedCompound>& q) const;
+
+            /**
+             * @brief The front of the txQueue can be transmitted within the
+             * maxOnAir limit and the BlockACK window
+             */
+            bool
+            frontFitsOnAir() const;
 
             wns::ldk::CompoundPtr baREQ;
             wifimac::management::PERInformationBase* perMIB;
@@ -180,8 +207,12 @@ namespace wifimac {
             size_t maxOnAir;
             const BlockACK* parent;
             const wns::service::dll::UnicastAddress adr;
-            std::deque<CompoundPtrWithTime> txQueue;
-            std::deque<CompoundPtrWithTime> onAirQueue;
+            std::deque<QueuedCompound> txQueue;
+            std::deque<QueuedCompound> onAirQueue;
+            /** @brief Sum of the sizes in the txQueue */
+            unsigned int txSize;
+            /** @brief Sum of the sizes in the onAirQueue */
+            unsigned int onAirSize;
             BlockACKCommand::SequenceNumber nextSN;
             bool waitForACK;
             bool baReqRequired;
@@ -81,7 +81,7 @@ ARFwithMIMO::ARFwithMIMO(
         {
             friends.manager->getPhyUser()->getPhyModeProvider()->mcsDown(pm);
         }
-        pm.setUniformMCS(pm.getSpatialStreams()[0], i);
+        pm.setUniformMCS(pm.getMCS(0), i);
         while(!friends.manager->getPhyUser()->getPhyModeProvider()->hasHighestMCS(pm))
         {
             allPMs.push_back(pm);
@@ -112,7 +112,7 @@ PERwithMIMO::reducePhyMode(wifimac::convergence::PhyMode& pm, unsigned int maxNu
     {
         if(pm.getNumberOfSpatialStreams() > 1)
         {
-            pm.setUniformMCS(pm.getSpatialStreams()[0], pm.getNumberOfSpatialStreams() - 1);
+            pm.setUniformMCS(pm.getMCS(0), pm.getNumberOfSpatialStreams() - 1);
             for(int i = 0; i < phyModeIncreaseOnAntennaDecrease; ++i)
             {
                 friends.phyUser->getPhyModeProvider()->mcsUp(pm);
@@ -133,7 +133,7 @@ PERwithMIMO::increasePhyMode(wifimac::convergence::PhyMode& pm, unsigned int max
     {
         if(pm.getNumberOfSpatialStreams() < maxNumSS)
         {
-            pm.setUniformMCS(pm.getSpatialStreams()[0], pm.getNumberOfSpatialStreams() + 1);
+            pm.setUniformMCS(pm.getMCS(0), pm.getNumberOfSpatialStreams() + 1);
             for(int i = 0; i < phyModeDecreaseOnAntennaIncrease; ++i)
             {
                 friends.phyUser->getPhyModeProvider()->mcsDown(pm);
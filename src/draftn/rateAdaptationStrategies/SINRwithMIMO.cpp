@@ -78,7 +78,7 @@ SINRwithMIMO::getPhyMode(size_t numTransmissions, const wns::Ratio lqm) const
     MESSAGE_END();
 
     wifimac::convergence::PhyMode bestPM = friends.phyUser->getPhyModeProvider()->getDefaultPhyMode();
-    bestPM.setUniformMCS(bestPM.getSpatialStreams()[0], 1);
+    bestPM.setUniformMCS(bestPM.getMCS(0), 1);
     bool foundBestPM = false;
 
     for(unsigned int numSS = maxNumSS; numSS >= 1; --numSS)
@@ -116,7 +116,7 @@ SINRwithMIMO::getPhyMode(size_t numTransmissions, const wns::Ratio lqm) const
                 {
                     wifimac::convergence::PhyMode singleStreamPM = singleStreamRA.getPhyMode(numTransmissions, streamLQM);
                     MESSAGE_SINGLE(NORMAL, *logger, "lqm for stream is " << streamLQM << " -> " << singleStreamPM);
-                    mcs.push_back(singleStreamPM.getSpatialStreams()[0]);
+                    mcs.push_back(singleStreamPM.getMCS(0));
                 }
             }
             if(not reduceAntennas)
@@ -0,0 +1,325 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/draftn/tests/BlockACKScoreboardTest.hpp>
+
+#include <WNS/Assure.hpp>
+
+#include <set>
+
+using namespace wifimac::draftn::tests;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BlockACKScoreboardTest );
+
+BlockACKScoreboardTest::BlockACKScoreboardTest():
+    wns::TestFixture(),
+    sb(NULL),
+    random()
+{
+}
+
+void BlockACKScoreboardTest::prepare()
+{
+    assure(this->sb == NULL, "not properly deleted");
+    this->sb = new BlockACKScoreboard();
+    this->random.reset();
+}
+
+void BlockACKScoreboardTest::cleanup()
+{
+    assure(this->sb != NULL, "not properly created");
+    delete this->sb;
+    this->sb = NULL;
+}
+
+void BlockACKScoreboardTest::insertEraseClear()
+{
+    CPPUNIT_ASSERT(sb->empty());
+    CPPUNIT_ASSERT_EQUAL(0, sb->count());
+
+    sb->insert(1000);
+    sb->insert(1001);
+    sb->insert(1100);
+    sb->insert(1001);
+    CPPUNIT_ASSERT(not sb->empty());
+    CPPUNIT_ASSERT_EQUAL(3, sb->count());
+    CPPUNIT_ASSERT(sb->contains(1000));
+    CPPUNIT_ASSERT(sb->contains(1001));
+    CPPUNIT_ASSERT(sb->contains(1100));
+    CPPUNIT_ASSERT(not sb->contains(1002));
+    CPPUNIT_ASSERT(not sb->contains(999));
+    CPPUNIT_ASSERT(not sb->contains(1000 + BlockACKScoreboard::windowSize));
+
+    sb->erase(1001);
+    // SNs outside of the window are ignored
+    sb->erase(5);
+    sb->erase(5000);
+    CPPUNIT_ASSERT_EQUAL(2, sb->count());
+    CPPUNIT_ASSERT(not sb->contains(1001));
+
+    sb->clear();
+    CPPUNIT_ASSERT(sb->empty());
+    CPPUNIT_ASSERT(not sb->contains(1000));
+
+    // the first insert into an empty scoreboard sets the start
+    sb->insert(17);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(17), sb->getStartSN());
+    CPPUNIT_ASSERT(sb->contains(17));
+}
+
+void BlockACKScoreboardTest::firstLast()
+{
+    // one SN in each of three different words
+    sb->insert(37);
+    sb->insert(5);
+    sb->insert(200);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(5), sb->first());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(200), sb->last());
+
+    sb->erase(5);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(37), sb->first());
+    sb->erase(200);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(37), sb->last());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(37), sb->first());
+
+    // lowest and highest bit of the window
+    sb->clear();
+    sb->insert(64);
+    sb->insert(64 + BlockACKScoreboard::windowSize - 1);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(64), sb->first());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(64 + BlockACKScoreboard::windowSize - 1), sb->last());
+}
+
+void BlockACKScoreboardTest::moveStartBackward()
+{
+    sb->insert(300);
+    sb->insert(331);
+    sb->insert(350);
+
+    // shift within a word
+    sb->insert(299);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(299), sb->getStartSN());
+    // shift by exactly one word
+    sb->insert(267);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(267), sb->getStartSN());
+    // shift across words
+    sb->insert(200);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(200), sb->getStartSN());
+
+    CPPUNIT_ASSERT_EQUAL(6, sb->count());
+    CPPUNIT_ASSERT(sb->contains(200));
+    CPPUNIT_ASSERT(sb->contains(267));
+    CPPUNIT_ASSERT(sb->contains(299));
+    CPPUNIT_ASSERT(sb->contains(300));
+    CPPUNIT_ASSERT(sb->contains(331));
+    CPPUNIT_ASSERT(sb->contains(350));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(200), sb->first());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(350), sb->last());
+
+    // the largest SN still fits exactly
+    sb->insert(350 - BlockACKScoreboard::windowSize + 1);
+    CPPUNIT_ASSERT_EQUAL(7, sb->count());
+    CPPUNIT_ASSERT(sb->contains(350));
+}
+
+void BlockACKScoreboardTest::moveStartForward()
+{
+    sb->insert(10);
+    sb->insert(100);
+    sb->insert(150);
+    sb->erase(10);
+
+    // the window moves up to the first contained SN, nothing falls out
+    sb->insert(300);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(100), sb->getStartSN());
+    CPPUNIT_ASSERT_EQUAL(3, sb->count());
+    CPPUNIT_ASSERT(sb->contains(100));
+    CPPUNIT_ASSERT(sb->contains(150));
+    CPPUNIT_ASSERT(sb->contains(300));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(100), sb->first());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(300), sb->last());
+}
+
+void BlockACKScoreboardTest::discardBefore()
+{
+    for(SequenceNumber sn = 10; sn < 200; sn += 3)
+    {
+        sb->insert(sn);
+    }
+
+    // smaller than the start: no change
+    sb->discardBefore(5);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(10), sb->getStartSN());
+    CPPUNIT_ASSERT(sb->contains(10));
+
+    // shift within a word
+    sb->discardBefore(20);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(20), sb->getStartSN());
+    CPPUNIT_ASSERT(not sb->contains(19));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(22), sb->first());
+
+    // shift by exactly one word
+    sb->discardBefore(52);
+    CPPUNIT_ASSERT(not sb->contains(49));
+    CPPUNIT_ASSERT(sb->contains(52));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(52), sb->first());
+
+    // shift across words
+    sb->discardBefore(121);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(121), sb->first());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(199), sb->last());
+    int expected = 0;
+    for(SequenceNumber sn = 121; sn < 200; sn += 3)
+    {
+        CPPUNIT_ASSERT(sb->contains(sn));
+        CPPUNIT_ASSERT(not sb->contains(sn + 1));
+        ++expected;
+    }
+    CPPUNIT_ASSERT_EQUAL(expected, sb->count());
+
+    // beyond the window: all SNs fall out
+    sb->discardBefore(121 + BlockACKScoreboard::windowSize);
+    CPPUNIT_ASSERT(sb->empty());
+}
+
+void BlockACKScoreboardTest::overflowSlidesWindow()
+{
+    for(SequenceNumber sn = 0; sn < BlockACKScoreboard::windowSize; ++sn)
+    {
+        sb->insert(sn);
+    }
+    CPPUNIT_ASSERT_EQUAL(BlockACKScoreboard::windowSize, sb->count());
+
+    // one SN more: the window ends at it and the smallest SN falls out
+    sb->insert(BlockACKScoreboard::windowSize);
+    CPPUNIT_ASSERT_EQUAL(BlockACKScoreboard::windowSize, sb->count());
+    CPPUNIT_ASSERT(not sb->contains(0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(1), sb->getStartSN());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(1), sb->first());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(BlockACKScoreboard::windowSize), sb->last());
+
+    // a jump by 40 SNs, not a multiple of the word size
+    sb->insert(BlockACKScoreboard::windowSize + 40);
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(41), sb->getStartSN());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(41), sb->first());
+    CPPUNIT_ASSERT_EQUAL(BlockACKScoreboard::windowSize - 40 + 1, sb->count());
+
+    // far beyond the window: only the new SN remains
+    sb->insert(10000);
+    CPPUNIT_ASSERT_EQUAL(1, sb->count());
+    CPPUNIT_ASSERT(sb->contains(10000));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(10000 - BlockACKScoreboard::windowSize + 1), sb->getStartSN());
+}
+
+void BlockACKScoreboardTest::overflowIgnoresOldSN()
+{
+    sb->insert(600);
+    sb->insert(700);
+
+    // does not fit into the window ending at 700
+    sb->insert(700 - BlockACKScoreboard::windowSize);
+    CPPUNIT_ASSERT_EQUAL(2, sb->count());
+    CPPUNIT_ASSERT(not sb->contains(700 - BlockACKScoreboard::windowSize));
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(600), sb->first());
+
+    // fits, the window moves back
+    sb->insert(500);
+    CPPUNIT_ASSERT_EQUAL(3, sb->count());
+    CPPUNIT_ASSERT_EQUAL(static_cast<SequenceNumber>(500), sb->getStartSN());
+    CPPUNIT_ASSERT(sb->contains(700));
+}
+
+void BlockACKScoreboardTest::randomOperations()
+{
+    // reference: the SNs in a set, with the window rules of insert
+    std::set<SequenceNumber> expected;
+    const int w = BlockACKScoreboard::windowSize;
+    SequenceNumber base = 1000;
+
+    for(int op = 0; op < 20000; ++op)
+    {
+        const int action = random(10);
+        if(action < 6)
+        {
+            const SequenceNumber sn = base + random(2 * w) - w / 2;
+            if(expected.empty())
+            {
+                expected.insert(sn);
+            }
+            else if(*expected.rbegin() - sn >= w)
+            {
+                // too old, ignored
+            }
+            else
+            {
+                expected.insert(sn);
+                while(*expected.rbegin() - *expected.begin() >= w)
+                {
+                    expected.erase(expected.begin());
+                }
+            }
+            sb->insert(sn);
+        }
+        else if(action < 8)
+        {
+            const SequenceNumber sn = base + random(2 * w) - w / 2;
+            expected.erase(sn);
+            sb->erase(sn);
+        }
+        else if(action < 9)
+        {
+            const SequenceNumber sn = base + random(w) - w / 2;
+            if(sn > sb->getStartSN())
+            {
+                expected.erase(expected.begin(), expected.lower_bound(sn));
+            }
+            sb->discardBefore(sn);
+        }
+        else
+        {
+            // the SNs go up over time
+            base += random(w / 2);
+        }
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(expected.size()), sb->count());
+        CPPUNIT_ASSERT_EQUAL(expected.empty(), sb->empty());
+        if(not expected.empty())
+        {
+            CPPUNIT_ASSERT_EQUAL(*expected.begin(), sb->first());
+            CPPUNIT_ASSERT_EQUAL(*expected.rbegin(), sb->last());
+            CPPUNIT_ASSERT(sb->last() - sb->getStartSN() < w);
+        }
+        if(op % 100 == 0)
+        {
+            for(SequenceNumber sn = base - 2 * w; sn < base + 2 * w; ++sn)
+            {
+                CPPUNIT_ASSERT_EQUAL(expected.find(sn) != expected.end(), sb->contains(sn));
+            }
+        }
+    }
+}
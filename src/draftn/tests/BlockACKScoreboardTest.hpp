@@ -0,0 +1,81 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_DRAFTN_TESTS_BLOCKACKSCOREBOARDTEST_HPP
+#define WIFIMAC_DRAFTN_TESTS_BLOCKACKSCOREBOARDTEST_HPP
+
+#include <WIFIMAC/draftn/BlockACKScoreboard.hpp>
+
+#include <WIFIMAC/helper/tests/Random.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+namespace wifimac { namespace draftn { namespace tests {
+
+    class BlockACKScoreboardTest:
+        public wns::TestFixture
+    {
+        CPPUNIT_TEST_SUITE( BlockACKScoreboardTest );
+        CPPUNIT_TEST( insertEraseClear );
+        CPPUNIT_TEST( firstLast );
+        CPPUNIT_TEST( moveStartBackward );
+        CPPUNIT_TEST( moveStartForward );
+        CPPUNIT_TEST( discardBefore );
+        CPPUNIT_TEST( overflowSlidesWindow );
+        CPPUNIT_TEST( overflowIgnoresOldSN );
+        CPPUNIT_TEST( randomOperations );
+        CPPUNIT_TEST_SUITE_END();
+
+        typedef BlockACKScoreboard::SequenceNumber SequenceNumber;
+
+    public:
+        BlockACKScoreboardTest();
+
+    private:
+        virtual void prepare();
+        virtual void cleanup();
+
+        // the tests
+        void insertEraseClear();
+        void firstLast();
+        void moveStartBackward();
+        void moveStartForward();
+        void discardBefore();
+        void overflowSlidesWindow();
+        void overflowIgnoresOldSN();
+        void randomOperations();
+
+        BlockACKScoreboard* sb;
+        wifimac::helper::tests::Random random;
+    };
+
+} // tests
+} // draftn
+} // wifimac
+
+#endif // WIFIMAC_DRAFTN_TESTS_BLOCKACKSCOREBOARDTEST_HPP
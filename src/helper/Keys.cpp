@@ -60,7 +60,7 @@ LinkByReceiver::LinkByReceiver(
 	const wns::ldk::CompoundPtr& compound,
 	int direction)
 {
-	dll::UpperCommand* uc = factory->fun->getCommandReader("upperConvergence")->readCommand<dll::UpperCommand>(compound->getCommandPool());
+	dll::UpperCommand* uc = factory->ucReader->readCommand<dll::UpperCommand>(compound->getCommandPool());
 
 	if(direction == wns::ldk::Direction::OUTGOING())
 	{
@@ -94,18 +94,33 @@ std::string LinkByReceiver::str() const
 }
 
 LinkByReceiverBuilder::LinkByReceiverBuilder(const wns::ldk::fun::FUN* _fun, const wns::pyconfig::View& /*config*/) :
-	fun(_fun)
+	fun(_fun),
+	ucReader(NULL),
+	keys()
 {
 }
 
 void LinkByReceiverBuilder::onFUNCreated()
 {
-
+	ucReader = fun->getCommandReader("upperConvergence");
 }
 
 wns::ldk::ConstKeyPtr LinkByReceiverBuilder::operator () (const wns::ldk::CompoundPtr& compound, int direction) const
 {
-	return wns::ldk::ConstKeyPtr(new LinkByReceiver(this, compound, direction));
+	dll::UpperCommand* uc = ucReader->readCommand<dll::UpperCommand>(compound->getCommandPool());
+	int linkId = (direction == wns::ldk::Direction::OUTGOING()) ?
+		uc->peer.targetMACAddress.getInteger() :
+		uc->peer.sourceMACAddress.getInteger();
+
+	boost::unordered_map<int, wns::ldk::ConstKeyPtr>::const_iterator it = keys.find(linkId);
+	if(it != keys.end())
+	{
+		return it->second;
+	}
+
+	wns::ldk::ConstKeyPtr key(new LinkByReceiver(this, compound, direction));
+	keys[linkId] = key;
+	return key;
 }
 
 // LinkByTransmitter Implementation
@@ -114,7 +129,7 @@ LinkByTransmitter::LinkByTransmitter(
 	const wns::ldk::CompoundPtr& compound,
 	int direction)
 {
-	dll::UpperCommand* uc = factory->fun->getCommandReader("upperConvergence")->readCommand<dll::UpperCommand>(compound->getCommandPool());
+	dll::UpperCommand* uc = factory->ucReader->readCommand<dll::UpperCommand>(compound->getCommandPool());
 
 	if(direction == wns::ldk::Direction::OUTGOING())
 	{
@@ -148,18 +163,33 @@ std::string LinkByTransmitter::str() const
 }
 
 LinkByTransmitterBuilder::LinkByTransmitterBuilder(const wns::ldk::fun::FUN* _fun, const wns::pyconfig::View& /*config*/) :
-	fun(_fun)
+	fun(_fun),
+	ucReader(NULL),
+	keys()
 {
 }
 
 void LinkByTransmitterBuilder::onFUNCreated()
 {
-
+	ucReader = fun->getCommandReader("upperConvergence");
 }
 
 wns::ldk::ConstKeyPtr LinkByTransmitterBuilder::operator () (const wns::ldk::CompoundPtr& compound, int direction) const
 {
-	return wns::ldk::ConstKeyPtr(new LinkByTransmitter(this, compound, direction));
+	dll::UpperCommand* uc = ucReader->readCommand<dll::UpperCommand>(compound->getCommandPool());
+	int linkId = (direction == wns::ldk::Direction::OUTGOING()) ?
+		uc->peer.sourceMACAddress.getInteger() :
+		uc->peer.targetMACAddress.getInteger();
+
+	boost::unordered_map<int, wns::ldk::ConstKeyPtr>::const_iterator it = keys.find(linkId);
+	if(it != keys.end())
+	{
+		return it->second;
+	}
+
+	wns::ldk::ConstKeyPtr key(new LinkByTransmitter(this, compound, direction));
+	keys[linkId] = key;
+	return key;
 }
 
 // TransmitterReceiver Implementation
@@ -168,7 +198,7 @@ TransmitterReceiver::TransmitterReceiver(
 	const wns::ldk::CompoundPtr& compound,
 	int direction)
 {
-	dll::UpperCommand* uc = factory->fun->getCommandReader("upperConvergence")->readCommand<dll::UpperCommand>(compound->getCommandPool());
+	dll::UpperCommand* uc = factory->ucReader->readCommand<dll::UpperCommand>(compound->getCommandPool());
 
 	if(direction == wns::ldk::Direction::OUTGOING())
 	{
@@ -210,16 +240,37 @@ std::string TransmitterReceiver::str() const
 }
 
 TransmitterReceiverBuilder::TransmitterReceiverBuilder(const wns::ldk::fun::FUN* _fun, const wns::pyconfig::View& /*config*/) :
-	fun(_fun)
+	fun(_fun),
+	ucReader(NULL),
+	keys()
 {
 }
 
 void TransmitterReceiverBuilder::onFUNCreated()
 {
-
+	ucReader = fun->getCommandReader("upperConvergence");
 }
 
 wns::ldk::ConstKeyPtr TransmitterReceiverBuilder::operator () (const wns::ldk::CompoundPtr& compound, int direction) const
 {
-	return wns::ldk::ConstKeyPtr(new TransmitterReceiver(this, compound, direction));
+	dll::UpperCommand* uc = ucReader->readCommand<dll::UpperCommand>(compound->getCommandPool());
+	std::pair<int, int> link;
+	if(direction == wns::ldk::Direction::OUTGOING())
+	{
+		link = std::make_pair(uc->peer.sourceMACAddress.getInteger(), uc->peer.targetMACAddress.getInteger());
+	}
+	else
+	{
+		link = std::make_pair(uc->peer.targetMACAddress.getInteger(), uc->peer.sourceMACAddress.getInteger());
+	}
+
+	boost::unordered_map<std::pair<int, int>, wns::ldk::ConstKeyPtr>::const_iterator it = keys.find(link);
+	if(it != keys.end())
+	{
+		return it->second;
+	}
+
+	wns::ldk::ConstKeyPtr key(new TransmitterReceiver(this, compound, direction));
+	keys[link] = key;
+	return key;
 }
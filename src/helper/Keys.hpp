@@ -32,9 +32,13 @@
 #include <WNS/ldk/Compound.hpp>
 #include <WNS/ldk/fun/FUN.hpp>
 #include <WNS/ldk/Key.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 #include <DLL/UpperConvergence.hpp>
 
+#include <boost/unordered_map.hpp>
+#include <utility>
+
 namespace wifimac { namespace helper {
 
 	/** @brief derived from wns::ldk::Key to disable flow separation */
@@ -54,17 +58,22 @@ namespace wifimac { namespace helper {
 			}
 	};
 
-	/** @brief wns::ldk::KeyBuilder for NoKey */
+	/** @brief wns::ldk::KeyBuilder for NoKey, all compounds share one key */
 	class NoKeyBuilder :
 		public wns::ldk::KeyBuilder
 	{
 	public:
-		NoKeyBuilder(const wns::ldk::fun::FUN* /*fun*/, const wns::pyconfig::View& /*config*/){}; 
+		NoKeyBuilder(const wns::ldk::fun::FUN* /*fun*/, const wns::pyconfig::View& /*config*/) :
+			noKey(new NoKey())
+			{};
 		virtual void onFUNCreated(){};
 		virtual wns::ldk::ConstKeyPtr operator () (const wns::ldk::CompoundPtr& /*compound*/, int /*direction*/) const
 			{
-				return wns::ldk::ConstKeyPtr(new NoKey());
+				return noKey;
 			}
+
+	private:
+		const wns::ldk::ConstKeyPtr noKey;
 	};
 
 	class LinkByReceiverBuilder;
@@ -81,7 +90,12 @@ namespace wifimac { namespace helper {
 		wns::service::dll::UnicastAddress linkId;
 	};
 
-	/** @brief wns::ldk::KeyBuilder for the LinkByReceiver key */
+	/**
+	 * @brief wns::ldk::KeyBuilder for the LinkByReceiver key
+	 *
+	 * One key per link is created on first use and handed out for all
+	 * following compounds of this link.
+	 */
 	class LinkByReceiverBuilder :
 		public wns::ldk::KeyBuilder
 	{
@@ -91,6 +105,11 @@ namespace wifimac { namespace helper {
 		virtual wns::ldk::ConstKeyPtr operator () (const wns::ldk::CompoundPtr& compound, int direction) const;
 
 		const wns::ldk::fun::FUN* fun;
+		wns::ldk::CommandReaderInterface* ucReader;
+
+	private:
+		/** @brief Keys by link address integer */
+		mutable boost::unordered_map<int, wns::ldk::ConstKeyPtr> keys;
 	};
 
 	class LinkByTransmitterBuilder;
@@ -107,7 +126,12 @@ namespace wifimac { namespace helper {
 		wns::service::dll::UnicastAddress linkId;
 	};
 
-	/** @brief wns::ldk::KeyBuilder for the LinkByTransmitter key */
+	/**
+	 * @brief wns::ldk::KeyBuilder for the LinkByTransmitter key
+	 *
+	 * One key per link is created on first use and handed out for all
+	 * following compounds of this link.
+	 */
 	class LinkByTransmitterBuilder :
 		public wns::ldk::KeyBuilder
 	{
@@ -117,6 +141,11 @@ namespace wifimac { namespace helper {
 		virtual wns::ldk::ConstKeyPtr operator () (const wns::ldk::CompoundPtr& compound, int direction) const;
 
 		const wns::ldk::fun::FUN* fun;
+		wns::ldk::CommandReaderInterface* ucReader;
+
+	private:
+		/** @brief Keys by link address integer */
+		mutable boost::unordered_map<int, wns::ldk::ConstKeyPtr> keys;
 	};
 
 	class TransmitterReceiverBuilder;
@@ -137,7 +166,12 @@ namespace wifimac { namespace helper {
 		wns::service::dll::UnicastAddress rx;
 	};
 
-	/** @brief wns::ldk::KeyBuilder for the TransmitterReceiver key */
+	/**
+	 * @brief wns::ldk::KeyBuilder for the TransmitterReceiver key
+	 *
+	 * One key per (transmitter, receiver) pair is created on first use and
+	 * handed out for all following compounds of this pair.
+	 */
 	class TransmitterReceiverBuilder :
 		public wns::ldk::KeyBuilder
 	{
@@ -147,6 +181,11 @@ namespace wifimac { namespace helper {
 		virtual wns::ldk::ConstKeyPtr operator () (const wns::ldk::CompoundPtr& compound, int direction) const;
 
 		const wns::ldk::fun::FUN* fun;
+		wns::ldk::CommandReaderInterface* ucReader;
+
+	private:
+		/** @brief Keys by (tx, rx) address integers */
+		mutable boost::unordered_map<std::pair<int, int>, wns::ldk::ConstKeyPtr> keys;
 	};
 
 } // Helper
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_HELPER_TESTS_RANDOM_HPP
+#define WIFIMAC_HELPER_TESTS_RANDOM_HPP
+
+#include <WNS/Assure.hpp>
+
+namespace wifimac { namespace helper { namespace tests {
+
+    /**
+     * @brief Reproducible pseudo random numbers for randomized unit tests
+     *
+     * A linear congruential generator with its own state, so that a test
+     * draws the same sequence on all platforms and independent of the other
+     * tests and of the simulator's RNG.
+     */
+    class Random
+    {
+    public:
+        explicit
+        Random(unsigned int _seed = defaultSeed):
+            state(_seed)
+            {}
+
+        /**
+         * @brief Restart the sequence
+         */
+        void
+        reset(unsigned int _seed = defaultSeed)
+            { state = _seed; }
+
+        /**
+         * @brief Next pseudo random number in [0, max)
+         */
+        int
+        operator()(int max)
+            {
+                assure(max > 0 and max <= 32768, "max " << max << " is out of range");
+                state = state * 1103515245 + 12345;
+                return static_cast<int>((state / 65536) % 32768) % max;
+            }
+
+    private:
+        static const unsigned int defaultSeed = 4711;
+
+        unsigned int state;
+    };
+
+} // tests
+} // helper
+} // wifimac
+
+#endif // WIFIMAC_HELPER_TESTS_RANDOM_HPP
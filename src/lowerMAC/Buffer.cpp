@@ -27,6 +27,8 @@
 
 #include <WIFIMAC/lowerMAC/Buffer.hpp>
 
+#include <WNS/probe/bus/utils.hpp>
+
 using namespace wifimac::lowerMAC;
 
 STATIC_FACTORY_REGISTER_WITH_CREATOR(
@@ -56,6 +58,8 @@ Buffer::Buffer(wns::ldk::fun::FUN* fuNet, const wns::pyconfig::View& config) :
     dropper(),
     totalPDUs(),
     droppedPDUs(),
+    expiryOrdered(true),
+    lastExpiration(0),
     logger("WNS", config.get<std::string>("name"))
 {
     {
@@ -69,6 +73,16 @@ Buffer::Buffer(wns::ldk::fun::FUN* fuNet, const wns::pyconfig::View& config) :
         std::string pluginName = config.get<std::string>("drop");
         dropper = std::auto_ptr<wns::ldk::buffer::dropping::Drop>(wns::ldk::buffer::dropping::Drop::Factory::creator(pluginName)->create());
     }
+
+    // read the localIDs from the config
+    wns::probe::bus::ContextProviderCollection localContext(&fuNet->getLayer()->getContextProviderCollection());
+    for (int ii = 0; ii<config.len("localIDs.keys()"); ++ii)
+    {
+        std::string key = config.get<std::string>("localIDs.keys()",ii);
+        unsigned int value  = config.get<unsigned int>("localIDs.values()",ii);
+        localContext.addProvider(wns::probe::bus::contextprovider::Constant(key, value));
+    }
+    lifetimeDropsProbe = wns::probe::bus::collector(localContext, config, "lifetimeDropsProbeName");
 } // Buffer
 
 Buffer::Buffer(const Buffer& other) :
@@ -92,6 +106,9 @@ Buffer::Buffer(const Buffer& other) :
 	dropper(wns::clone(other.dropper)),
 	totalPDUs(other.totalPDUs),
 	droppedPDUs(other.droppedPDUs),
+	expiryOrdered(other.expiryOrdered),
+	lastExpiration(other.lastExpiration),
+	lifetimeDropsProbe(other.lifetimeDropsProbe),
 	logger(other.logger)
 {
 	friends.ra = other.friends.ra;
@@ -135,6 +152,21 @@ Buffer::processOutgoing(const wns::ldk::CompoundPtr& compound)
 {
     checkLifetime();
 
+    // An expiration time of 0 never expires, i.e. it is later than any other
+    wns::simulator::Time expiration = friends.manager->getExpirationTime(compound->getCommandPool());
+    if(buffer.empty())
+    {
+        expiryOrdered = true;
+    }
+    else if(expiryOrdered and
+            ((lastExpiration == 0 and expiration != 0) or
+             (expiration != 0 and expiration < lastExpiration)))
+    {
+        MESSAGE_SINGLE(NORMAL, logger, "Compound expires before its predecessor, check complete buffer for lifetime");
+        expiryOrdered = false;
+    }
+    lastExpiration = expiration;
+
 	buffer.push_back(compound);
 	currentSize += (*sizeCalculator)(compound);
 
@@ -187,29 +219,56 @@ Buffer::getSomethingToSend()
 void
 Buffer::checkLifetime()
 {
-    for (wns::ldk::buffer::dropping::ContainerType::iterator it = buffer.begin();
-         it != buffer.end();
-        )
-    {
-        wns::ldk::buffer::dropping::ContainerType::iterator next = it;
-        ++next;
+    int drops = 0;
 
-        if(friends.manager->lifetimeExpired((*it)->getCommandPool()))
+    if(expiryOrdered)
+    {
+        // compounds expire in FIFO order, only the head has to be checked
+        while(not buffer.empty() and
+              friends.manager->lifetimeExpired(buffer.front()->getCommandPool()))
         {
-            int pduSize = (*sizeCalculator)(*it);
-            currentSize -= pduSize;
-            increaseDroppedPDUs(pduSize);
-            probe();
-
-            buffer.erase(it);
-
-            MESSAGE_BEGIN(NORMAL, logger, m, getFUN()->getName());
-            m << "PDU in queue has reached lifetime -> drop!";
-            m << "New size is " << currentSize;
-            MESSAGE_END();
+            dropExpired(buffer.begin());
+            ++drops;
         }
-        it = next;
     }
+    else
+    {
+        for (wns::ldk::buffer::dropping::ContainerType::iterator it = buffer.begin();
+             it != buffer.end();
+            )
+        {
+            wns::ldk::buffer::dropping::ContainerType::iterator next = it;
+            ++next;
+
+            if(friends.manager->lifetimeExpired((*it)->getCommandPool()))
+            {
+                dropExpired(it);
+                ++drops;
+            }
+            it = next;
+        }
+    }
+
+    if(drops > 0)
+    {
+        lifetimeDropsProbe->put(drops);
+    }
+}
+
+void
+Buffer::dropExpired(wns::ldk::buffer::dropping::ContainerType::iterator it)
+{
+    int pduSize = (*sizeCalculator)(*it);
+    currentSize -= pduSize;
+    increaseDroppedPDUs(pduSize);
+    probe();
+
+    buffer.erase(it);
+
+    MESSAGE_BEGIN(NORMAL, logger, m, getFUN()->getName());
+    m << "PDU in queue has reached lifetime -> drop!";
+    m << "New size is " << currentSize;
+    MESSAGE_END();
 }
 
 //
@@ -34,6 +34,7 @@
 #include <WIFIMAC/management/ProtocolCalculator.hpp>
 
 #include <WNS/ldk/buffer/Dropping.hpp>
+#include <WNS/probe/bus/ContextCollector.hpp>
 
 #include <list>
 #include <memory>
@@ -49,6 +50,12 @@ namespace wifimac { namespace lowerMAC {
 	 * Buffer class also implements the TXOPTimeWindow interface in order
 	 * to let the TXOP FU determine the size of the next compound waiting to
 	 * be passed to the FU below the buffer and /or the corresponding receiver
+	 *
+	 * Compounds whose lifetime has expired are dropped. As the expiration
+	 * time is set when the compound enters the MAC, the compounds are
+	 * usually stored in the order of their expiration, and only the head of
+	 * the queue has to be checked. The full queue is searched only as long
+	 * as this order does not hold.
 	 */
 	class Buffer :
 		public wns::ldk::buffer::Buffer,
@@ -139,6 +146,9 @@ namespace wifimac { namespace lowerMAC {
 		void onFUNCreated();
 	        void checkLifetime();
 
+		/** @brief Remove the expired compound and count the drop */
+		void dropExpired(wns::ldk::buffer::dropping::ContainerType::iterator it);
+
 		unsigned long int maxSize;
 		unsigned long int currentSize;
 		bool isActive;
@@ -148,6 +158,13 @@ namespace wifimac { namespace lowerMAC {
 		PDUCounter totalPDUs;
 		PDUCounter droppedPDUs;
 
+		/** @brief True if the buffered compounds are ordered by expiration time */
+		bool expiryOrdered;
+		/** @brief Expiration time of the last stored compound, 0 for none */
+		wns::simulator::Time lastExpiration;
+		/** @brief Number of compounds dropped by one lifetime check */
+		wns::probe::bus::ContextCollectorPtr lifetimeDropsProbe;
+
         const std::string raName;
         const std::string protocolCalculatorName;
         const std::string managerName;
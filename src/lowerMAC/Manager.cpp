@@ -35,6 +35,7 @@
 #include <DLL/Layer2.hpp>
 #include <WNS/service/dll/StationTypes.hpp>
 #include <WNS/ldk/FlowGate.hpp>
+#include <WNS/Exception.hpp>
 
 using namespace wifimac::lowerMAC;
 
@@ -52,11 +53,23 @@ Manager::Manager(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& config) :
     sifsDuration(config.get<wns::simulator::Time>("myConfig.sifsDuration")),
     myMACAddress_(config.get<wns::service::dll::UnicastAddress>("myMACAddress")),
     ucName_(config_.get<std::string>("upperConvergenceCommandName")),
+    ucReader_(NULL),
     numAntennas(config_.get<int>("myConfig.numAntennas")),
     msduLifetimeLimit(config_.get<wns::simulator::Time>("myConfig.msduLifetimeLimit")),
     associatedTo()
 {
     MESSAGE_SINGLE(NORMAL, logger_, "created");
+
+    // the PhyModes hold at most maxSpatialStreams streams, and the number of
+    // streams is derived from the number of antennas of both peers
+    if(numAntennas < 1 or numAntennas > wifimac::convergence::PhyMode::maxSpatialStreams)
+    {
+        wns::Exception e;
+        e << "numAntennas is " << numAntennas << ", but must be between 1 and "
+          << wifimac::convergence::PhyMode::maxSpatialStreams;
+        throw wns::Exception(e);
+    }
+
     friends.phyUser = NULL;
     friends.upperConvergence = NULL;
 }
@@ -99,6 +112,7 @@ Manager::onFUNCreated()
 
     // find upper convergence
     friends.upperConvergence = getFUN()->findFriend<dll::UpperConvergence*>(ucName_);
+    ucReader_ = getFUN()->getCommandReader(ucName_);
 
     // set the number of antennas for MIMO
     assure(wifimac::management::TheVCIBService::Instance().getVCIB(), "No virtual capability information base service found");
@@ -115,11 +129,11 @@ Manager::processIncoming(const wns::ldk::CompoundPtr& /*compound*/)
 void
 Manager::processOutgoing(const wns::ldk::CompoundPtr& compound)
 {
-    assure(getFUN()->getCommandReader(ucName_)
+    assure(ucReader_
            ->readCommand<dll::UpperCommand>(compound->getCommandPool())
            ->peer.sourceMACAddress == myMACAddress_,
            "Try to tx compound with source address " <<
-           getFUN()->getCommandReader(ucName_)
+           ucReader_
            ->readCommand<dll::UpperCommand>(compound->getCommandPool())
            ->peer.sourceMACAddress <<
            " from transceiver with MAC address " << myMACAddress_ );
@@ -213,7 +227,7 @@ Manager::createReply(const wns::ldk::CommandPool* original) const
 	wns::ldk::CommandPool* reply = this->getFUN()->getProxy()->createReply(original, this);
 
 	dll::UpperCommand* ucReply = getFUN()->getProxy()->getCommand<dll::UpperCommand>(reply, ucName_);
-	dll::UpperCommand* ucOriginal = getFUN()->getCommandReader(ucName_)->readCommand<dll::UpperCommand>(original);
+	dll::UpperCommand* ucOriginal = ucReader_->readCommand<dll::UpperCommand>(original);
 
 	// this cannot be set to this->myAddress_, because it is not defined which
 	// Manager-entity will be asked for createReply
@@ -239,21 +253,21 @@ Manager::createReply(const wns::ldk::CommandPool* original) const
 wns::service::dll::UnicastAddress
 Manager::getTransmitterAddress(const wns::ldk::CommandPool* commandPool) const
 {
-    return (getFUN()->getCommandReader(ucName_)->readCommand<dll::UpperCommand>(commandPool)->peer.sourceMACAddress);
+    return (ucReader_->readCommand<dll::UpperCommand>(commandPool)->peer.sourceMACAddress);
 }
 
 wns::service::dll::UnicastAddress
 Manager::getReceiverAddress(const wns::ldk::CommandPool* commandPool) const
 {
-    return (getFUN()->getCommandReader(ucName_)->readCommand<dll::UpperCommand>(commandPool)->peer.targetMACAddress);
+    return (ucReader_->readCommand<dll::UpperCommand>(commandPool)->peer.targetMACAddress);
 }
 
 bool
 Manager::isForMe(const wns::ldk::CommandPool* commandPool) const
 {
-    if(getFUN()->getCommandReader(ucName_)->commandIsActivated(commandPool))
+    if(ucReader_->commandIsActivated(commandPool))
     {
-        return(getFUN()->getCommandReader(ucName_)->readCommand<dll::UpperCommand>(commandPool)->peer.targetMACAddress == this->myMACAddress_);
+        return(ucReader_->readCommand<dll::UpperCommand>(commandPool)->peer.targetMACAddress == this->myMACAddress_);
     }
     else
     {
@@ -38,6 +38,7 @@
 #include <WNS/ldk/Command.hpp>
 #include <WNS/ldk/fu/Plain.hpp>
 #include <WNS/ldk/Processor.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 #include <WNS/service/dll/Address.hpp>
 
@@ -253,6 +254,7 @@ namespace wifimac { namespace lowerMAC {
 
         /** @brief Name of the upper convergence */
         const std::string ucName_;
+        wns::ldk::CommandReaderInterface* ucReader_;
 
         /** @brief Number of antennas of the receiver */
         const unsigned int numAntennas;
@@ -30,9 +30,16 @@
 
 #include <WNS/Assure.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
+#include <cmath>
 
 using namespace wifimac::lowerMAC::timing;
 
+namespace {
+    /** @brief A busy channel is detected only after this delay */
+    const wns::simulator::Time busyDetectionDelay = 1e-6;
+}
+
 Backoff::Backoff(BackoffObserver* _backoffObserver, const wns::pyconfig::View& _config) :
     backoffObserver(_backoffObserver),
     slotDuration(_config.get<wns::simulator::Time>("myConfig.slotDuration")),
@@ -47,13 +54,24 @@ Backoff::Backoff(BackoffObserver* _backoffObserver, const wns::pyconfig::View& _
     cw(cwMin),
     uniform(0.0, 1.0, wns::simulator::getRNG()),
     logger(_config.get("backoffLogger")),
+    aifsStart(),
+    countdownStart(),
     // we start with an idle channel
     channelIsBusy(false),
+    contentionDomain(_config.isNone("myConfig.contentionDomain") ?
+                     "" : _config.get<std::string>("myConfig.contentionDomain")),
+    coordinator(NULL),
     counter(0)
 {
     assureNotNull(backoffObserver);
     MESSAGE_SINGLE(NORMAL, logger, "created");
 
+    if(not contentionDomain.empty())
+    {
+        coordinator = TheContentionCoordinatorService::Instance().attach(contentionDomain);
+        MESSAGE_SINGLE(NORMAL, logger, "Using contention coordinator of " << contentionDomain);
+    }
+
     // start the initial backoff
     startNewBackoffCountdown(aifsDuration);
 }
@@ -61,6 +79,18 @@ Backoff::Backoff(BackoffObserver* _backoffObserver, const wns::pyconfig::View& _
 
 Backoff::~Backoff()
 {
+    if(coordinator != NULL)
+    {
+        if(coordinator->isInCarrierSense(this))
+        {
+            coordinator->leaveCarrierSense(this);
+        }
+        if(coordinator->hasClientTimeout(this))
+        {
+            coordinator->cancelClientTimeout(this);
+        }
+        TheContentionCoordinatorService::Instance().detach(contentionDomain);
+    }
 }
 
 wns::simulator::Time Backoff::finishedAt() const
@@ -87,7 +117,12 @@ wns::simulator::Time Backoff::finishedAt() const
             }
             else
             {
-                return now + counter * slotDuration;
+                int remaining = counter;
+                if(isCountingDown())
+                {
+                    remaining -= elapsedSlots();
+                }
+                return now + remaining * slotDuration;
             }
         }
     }
@@ -105,7 +140,67 @@ Backoff::startNewBackoffCountdown(wns::simulator::Time ifsDuration)
 
     MESSAGE_SINGLE(NORMAL, logger, "Start new backoff, waiting for AIFS=" << ifsDuration);
     // First stage: Try to survive AIFS
-    setNewTimeout(ifsDuration);
+    startTimer(ifsDuration);
+}
+
+void
+Backoff::onContentionTimeout()
+{
+    onTimeout();
+}
+
+void
+Backoff::onCarrierSenseBusy()
+{
+    channelIsBusy = true;
+}
+
+bool
+Backoff::onCarrierSenseFreeze()
+{
+    return(freezeCountdown());
+}
+
+void
+Backoff::onCarrierSenseIdle()
+{
+    onChannelIdle();
+}
+
+void
+Backoff::startTimer(const wns::simulator::Time& duration)
+{
+    if(coordinator != NULL)
+    {
+        coordinator->setClientTimeout(this, duration);
+    }
+    else
+    {
+        setNewTimeout(duration);
+    }
+}
+
+void
+Backoff::stopTimer()
+{
+    if(coordinator != NULL)
+    {
+        coordinator->cancelClientTimeout(this);
+    }
+    else
+    {
+        cancelTimeout();
+    }
+}
+
+bool
+Backoff::timerIsSet() const
+{
+    if(coordinator != NULL)
+    {
+        return(coordinator->hasClientTimeout(this));
+    }
+    return(hasTimeoutSet());
 }
 
 void
@@ -145,9 +240,9 @@ Backoff::onTimeout()
     }
     else
     {
-        // one further slot waited
-        --counter;
-        MESSAGE_SINGLE(NORMAL, logger, "Slot waited, counter is now " << counter);
+        // all slots waited
+        MESSAGE_SINGLE(NORMAL, logger, counter << " slots waited, counter is now 0");
+        counter = 0;
     }
 
     if(counter == 0)
@@ -171,10 +266,34 @@ Backoff::onTimeout()
     }
     else
     {
-        setTimeout(slotDuration);
+        startSlotCountdown();
     }
 }
 
+void
+Backoff::startSlotCountdown()
+{
+    assure(counter > 0, "no slots to count down");
+
+    countdownStart = wns::simulator::getEventScheduler()->getTime();
+    startTimer(counter * slotDuration);
+}
+
+int
+Backoff::elapsedSlots() const
+{
+    wns::simulator::Time elapsed = wns::simulator::getEventScheduler()->getTime() - countdownStart;
+
+    // A slot ending exactly now has passed: Its end would have been scheduled
+    // before any event of the current time. The tolerance absorbs the rounding
+    // of the time differences.
+    int slots = static_cast<int>(floor(elapsed / slotDuration + 1e-6));
+    assure(slots >= 0, "countdown started in the future");
+
+    // the last slot has passed only when the timeout has fired
+    return(std::min(slots, counter - 1));
+}
+
 bool
 Backoff::transmissionRequest(const int transmissionCounter)
 {
@@ -227,24 +346,52 @@ Backoff::onChannelIdle()
     }
 }
 
+void
+Backoff::startObservingChannelState(wifimac::convergence::ChannelStateNotification* channelState)
+{
+    if(coordinator != NULL)
+    {
+        coordinator->joinCarrierSense(this, channelState, busyDetectionDelay);
+    }
+    else
+    {
+        this->wns::Observer<wifimac::convergence::IChannelState>::startObserving(channelState);
+    }
+}
+
 void Backoff::onChannelBusy()
 {
     channelIsBusy = true;
 
     wns::simulator::getEventScheduler()->scheduleDelay(
         boost::bind(&wifimac::lowerMAC::timing::Backoff::channelBusyDelay, this),
-        1e-6);
+        busyDetectionDelay);
 }
 
 void Backoff::channelBusyDelay()
+{
+    if(freezeCountdown())
+    {
+        stopTimer();
+    }
+}
+
+bool
+Backoff::freezeCountdown()
 {
     aifsStart = wns::simulator::Time();
-    if(channelIsBusy and hasTimeoutSet())
+    if(channelIsBusy and timerIsSet())
     {
-        // abort countdown
-        cancelTimeout();
-        MESSAGE_SINGLE(NORMAL, logger, "Channel busy detected during countdown -> freeze.");
+        if(not duringAIFS)
+        {
+            // freeze the counter at the slots which are still to wait
+            counter -= elapsedSlots();
+        }
+
+        MESSAGE_SINGLE(NORMAL, logger, "Channel busy detected during countdown -> freeze with counter " << counter << ".");
+        return true;
     }
+    return false;
 }
 
 void
@@ -267,7 +414,7 @@ Backoff::onRxError()
     if(not  backoffFinished and duringAIFS and aifsStart == wns::simulator::getEventScheduler()->getTime())
     {
         // got onChannelIdle signal before onRxError signal
-        cancelTimeout();
+        stopTimer();
         startNewBackoffCountdown(eifsDuration);
     }
 }
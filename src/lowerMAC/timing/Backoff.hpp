@@ -31,6 +31,7 @@
 
 #include <WIFIMAC/convergence/IChannelState.hpp>
 #include <WIFIMAC/convergence/IRxStartEnd.hpp>
+#include <WIFIMAC/lowerMAC/timing/ContentionCoordinator.hpp>
 
 #include <WNS/Observer.hpp>
 
@@ -57,11 +58,21 @@ namespace wifimac { namespace lowerMAC { namespace timing {
 	 *
 	 * Essentially, the backoff in IEEE is very simple: Assure that between every channel busy->idle transition
 	 * and the node's transmission a backoff is counted to zero.
+	 *
+	 * The slots are not counted down one by one: After the AIFS, a single timeout is set to the end of the
+	 * last slot. If the channel becomes busy before, the number of slots which have passed since the start
+	 * of the countdown is computed and the remaining counter is frozen.
+	 *
+	 * If a contention domain is configured, the timeouts are not scheduled individually but at the
+	 * ContentionCoordinator of this channel, which is shared by all backoff instances of the channel.
+	 * The channel state transitions are then also delivered by the coordinator, which freezes and
+	 * restarts all backoff instances of the same channel state together.
 	 */
     class Backoff :
         public wns::events::CanTimeout,
         public wns::Observer<wifimac::convergence::IChannelState>,
-        public wns::Observer<wifimac::convergence::IRxStartEnd>
+        public wns::Observer<wifimac::convergence::IRxStartEnd>,
+        public ContentionCoordinator::CarrierSenseClient
     {
     public:
 
@@ -90,6 +101,10 @@ namespace wifimac { namespace lowerMAC { namespace timing {
         void
         onChannelIdle();
 
+        /** @brief Observe the channel state, via the coordinator if one is used */
+        void
+        startObservingChannelState(wifimac::convergence::ChannelStateNotification* channelState);
+
         int getCurrentCW() const
             {
                 return(cw);
@@ -110,10 +125,42 @@ namespace wifimac { namespace lowerMAC { namespace timing {
         /** @brief implementation of CanTimeout interface */
         void onTimeout();
 
+        /** @brief implementation of ContentionCoordinator::CarrierSenseClient interface */
+        void onContentionTimeout();
+        void onCarrierSenseBusy();
+        bool onCarrierSenseFreeze();
+        void onCarrierSenseIdle();
+
+        /** @brief Set the timer, either individually or at the coordinator, replaces a pending timeout */
+        void startTimer(const wns::simulator::Time& duration);
+
+        void stopTimer();
+
+        bool timerIsSet() const;
+
         void waitForTimer(const wns::simulator::Time& waitDuration);
 
         void channelBusyDelay();
 
+        /**
+         * @brief Freeze the counter after the busy detection delay
+         *
+         * Returns true if the countdown was running and the timer has to be stopped.
+         */
+        bool freezeCountdown();
+
+        /** @brief Start the countdown of the current counter after the AIFS */
+        void startSlotCountdown();
+
+        /** @brief Number of slots which have fully passed since the start of the countdown */
+        int elapsedSlots() const;
+
+        /** @brief True if the countdown of the slots is running */
+        bool isCountingDown() const
+            {
+                return(not duringAIFS and timerIsSet());
+            }
+
         BackoffObserver* backoffObserver;
         std::vector<BackoffObserver*> eobObserver;
 
@@ -132,11 +179,17 @@ namespace wifimac { namespace lowerMAC { namespace timing {
         wns::distribution::Uniform uniform;
         wns::logger::Logger logger;
         wns::simulator::Time aifsStart;
+        wns::simulator::Time countdownStart;
         bool channelIsBusy;
 
+        /** @brief Name of the channel for the shared coordinator, empty if not used */
+        const std::string contentionDomain;
+        ContentionCoordinator* coordinator;
+
     protected:
         // For testing purpose this methods and variable is protected and may be
-        // set by a special version of the backoff
+        // set by a special version of the backoff. During the countdown, it
+        // holds the counter at countdownStart
         int counter;
     };
 } // timing
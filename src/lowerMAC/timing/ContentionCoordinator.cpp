@@ -0,0 +1,412 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/lowerMAC/timing/ContentionCoordinator.hpp>
+#include <WIFIMAC/convergence/IChannelState.hpp>
+
+#include <WNS/Observer.hpp>
+#include <WNS/Assure.hpp>
+
+#include <algorithm>
+#include <deque>
+
+using namespace wifimac::lowerMAC::timing;
+
+/**
+ * @brief Observes the channel state once for all clients of the group
+ *
+ * The busy detection delay of the group is handled as a timeout at the
+ * coordinator, so that it is ordered with the timeouts of the clients.
+ */
+class ContentionCoordinator::CarrierSense :
+    public wns::Observer<wifimac::convergence::IChannelState>,
+    public ContentionCoordinator::Client
+{
+public:
+    CarrierSense(ContentionCoordinator* _coordinator,
+                 wifimac::convergence::ChannelStateNotification* _channelState,
+                 const wns::simulator::Time& _busyDelay):
+        coordinator(_coordinator),
+        channelState(_channelState),
+        busyDelay(_busyDelay),
+        clients(),
+        busyTransitions()
+        {}
+
+    void
+    onChannelBusy()
+        {
+            coordinator->onCarrierSenseBusy(this);
+        }
+
+    void
+    onChannelIdle()
+        {
+            coordinator->onCarrierSenseIdle(this);
+        }
+
+    /** @brief The busy detection delay of the earliest busy transition has passed */
+    void
+    onContentionTimeout()
+        {
+            coordinator->onCarrierSenseFreeze(this);
+        }
+
+    ContentionCoordinator* const coordinator;
+    wifimac::convergence::ChannelStateNotification* const channelState;
+    const wns::simulator::Time busyDelay;
+
+    std::vector<CarrierSenseClient*> clients;
+
+    /** @brief Times of the busy transitions whose delay has not passed yet */
+    std::deque<wns::simulator::Time> busyTransitions;
+};
+
+ContentionCoordinator::ContentionCoordinator(const std::string& channelName):
+    logger("WIFIMAC", "ContentionCoordinator." + channelName, wns::simulator::getMasterLogger()),
+    heap(),
+    sequence(0),
+    armedFor(),
+    notifying(false),
+    carrierSenses()
+{
+    MESSAGE_SINGLE(NORMAL, logger, "created");
+}
+
+ContentionCoordinator::~ContentionCoordinator()
+{
+    assure(heap.empty(), "Coordinator deleted with pending timeouts");
+    assure(carrierSenses.empty(), "Coordinator deleted with carrier sense groups");
+}
+
+void
+ContentionCoordinator::setClientTimeout(Client* client, const wns::simulator::Time& delay)
+{
+    assureNotNull(client);
+    assure(delay >= 0, "Timeout must not be in the past");
+
+    Entry entry;
+    entry.expiry = wns::simulator::getEventScheduler()->getTime() + delay;
+    entry.sequence = sequence++;
+    entry.client = client;
+
+    if(client->heapPosition == -1)
+    {
+        heap.push_back(entry);
+        place(entry, heap.size() - 1);
+        siftUp(client->heapPosition);
+    }
+    else
+    {
+        // replace the pending timeout
+        place(entry, client->heapPosition);
+        siftUp(client->heapPosition);
+        siftDown(client->heapPosition);
+    }
+
+    rearm();
+}
+
+void
+ContentionCoordinator::cancelClientTimeout(Client* client)
+{
+    assureNotNull(client);
+    assure(client->heapPosition != -1, "Client has no timeout set");
+
+    removeAt(client->heapPosition);
+    rearm();
+}
+
+void
+ContentionCoordinator::onTimeout()
+{
+    const wns::simulator::Time now = wns::simulator::getEventScheduler()->getTime();
+
+    // The event is scheduled as a delay, hence its time may differ from the
+    // expiry by rounding. All entries up to the expiry of the event are due.
+    const wns::simulator::Time due = std::max(now, armedFor);
+
+    notifying = true;
+    while(not heap.empty() and heap[0].expiry <= due)
+    {
+        Client* client = heap[0].client;
+        removeAt(0);
+        client->onContentionTimeout();
+    }
+    notifying = false;
+
+    rearm();
+}
+
+void
+ContentionCoordinator::joinCarrierSense(CarrierSenseClient* client,
+                                        wifimac::convergence::ChannelStateNotification* channelState,
+                                        const wns::simulator::Time& busyDelay)
+{
+    assureNotNull(client);
+    assureNotNull(channelState);
+    assure(client->carrierSense == NULL, "Client has already joined a carrier sense group");
+
+    CarrierSenseMap::iterator it = carrierSenses.find(channelState);
+    if(it == carrierSenses.end())
+    {
+        MESSAGE_SINGLE(NORMAL, logger, "Create carrier sense group");
+        CarrierSense* group = new CarrierSense(this, channelState, busyDelay);
+        group->startObserving(channelState);
+        it = carrierSenses.insert(std::make_pair(channelState, group)).first;
+    }
+    assure(it->second->busyDelay == busyDelay, "All clients of a carrier sense group must use the same busy delay");
+
+    it->second->clients.push_back(client);
+    client->carrierSense = it->second;
+}
+
+void
+ContentionCoordinator::leaveCarrierSense(CarrierSenseClient* client)
+{
+    assureNotNull(client);
+    assure(client->carrierSense != NULL, "Client has not joined a carrier sense group");
+
+    CarrierSense* group = client->carrierSense;
+    group->clients.erase(std::find(group->clients.begin(), group->clients.end(), client));
+    client->carrierSense = NULL;
+
+    if(group->clients.empty())
+    {
+        MESSAGE_SINGLE(NORMAL, logger, "Delete carrier sense group");
+        if(hasClientTimeout(group))
+        {
+            cancelClientTimeout(group);
+        }
+        carrierSenses.erase(group->channelState);
+        delete group;
+    }
+}
+
+void
+ContentionCoordinator::onCarrierSenseBusy(CarrierSense* group)
+{
+    for(size_t i = 0; i < group->clients.size(); ++i)
+    {
+        group->clients[i]->onCarrierSenseBusy();
+    }
+
+    // Only the earliest pending busy transition has a timeout, the others
+    // follow when it has passed
+    group->busyTransitions.push_back(wns::simulator::getEventScheduler()->getTime());
+    if(group->busyTransitions.size() == 1)
+    {
+        setClientTimeout(group, group->busyDelay);
+    }
+}
+
+void
+ContentionCoordinator::onCarrierSenseFreeze(CarrierSense* group)
+{
+    // called from onTimeout, hence the event is rescheduled only once after
+    // all timeouts of the group are removed
+    assure(notifying, "Busy delay must be notified by the coordinator");
+
+    group->busyTransitions.pop_front();
+
+    int numFrozen = 0;
+    for(size_t i = 0; i < group->clients.size(); ++i)
+    {
+        CarrierSenseClient* client = group->clients[i];
+        if(client->onCarrierSenseFreeze())
+        {
+            assure(hasClientTimeout(client), "Frozen client has no timeout set");
+            removeAt(client->heapPosition);
+            ++numFrozen;
+        }
+    }
+    MESSAGE_SINGLE(NORMAL, logger, "Channel busy, froze " << numFrozen << " of " << group->clients.size() << " clients");
+
+    if(not group->busyTransitions.empty())
+    {
+        const wns::simulator::Time delay =
+            group->busyTransitions.front() + group->busyDelay - wns::simulator::getEventScheduler()->getTime();
+        setClientTimeout(group, std::max(delay, wns::simulator::Time(0)));
+    }
+}
+
+void
+ContentionCoordinator::onCarrierSenseIdle(CarrierSense* group)
+{
+    // the clients restart their countdowns, the event is rescheduled once
+    // afterwards
+    const bool wasNotifying = notifying;
+    notifying = true;
+    for(size_t i = 0; i < group->clients.size(); ++i)
+    {
+        group->clients[i]->onCarrierSenseIdle();
+    }
+    notifying = wasNotifying;
+
+    rearm();
+}
+
+void
+ContentionCoordinator::place(const Entry& entry, int position)
+{
+    heap[position] = entry;
+    heap[position].client->heapPosition = position;
+}
+
+void
+ContentionCoordinator::siftUp(int position)
+{
+    const Entry entry = heap[position];
+    while(position > 0)
+    {
+        int parent = (position - 1) / 2;
+        if(not before(entry, heap[parent]))
+        {
+            break;
+        }
+        place(heap[parent], position);
+        position = parent;
+    }
+    place(entry, position);
+}
+
+void
+ContentionCoordinator::siftDown(int position)
+{
+    const Entry entry = heap[position];
+    const int size = heap.size();
+    while(true)
+    {
+        int child = 2 * position + 1;
+        if(child >= size)
+        {
+            break;
+        }
+        if(child + 1 < size and before(heap[child + 1], heap[child]))
+        {
+            ++child;
+        }
+        if(not before(heap[child], entry))
+        {
+            break;
+        }
+        place(heap[child], position);
+        position = child;
+    }
+    place(entry, position);
+}
+
+void
+ContentionCoordinator::removeAt(int position)
+{
+    heap[position].client->heapPosition = -1;
+
+    const int last = heap.size() - 1;
+    if(position != last)
+    {
+        // fill the gap with the last entry and restore the heap order
+        Client* moved = heap[last].client;
+        place(heap[last], position);
+        heap.pop_back();
+        siftUp(moved->heapPosition);
+        siftDown(moved->heapPosition);
+    }
+    else
+    {
+        heap.pop_back();
+    }
+}
+
+void
+ContentionCoordinator::rearm()
+{
+    if(notifying)
+    {
+        return;
+    }
+
+    if(heap.empty())
+    {
+        if(hasTimeoutSet())
+        {
+            cancelTimeout();
+        }
+        return;
+    }
+
+    if(hasTimeoutSet() and armedFor == heap[0].expiry)
+    {
+        return;
+    }
+
+    armedFor = heap[0].expiry;
+    setNewTimeout(armedFor - wns::simulator::getEventScheduler()->getTime());
+}
+
+ContentionCoordinatorService::ContentionCoordinatorService():
+    logger("WIFIMAC", "ContentionCoordinatorService", wns::simulator::getMasterLogger()),
+    coordinators()
+{
+}
+
+ContentionCoordinatorService::~ContentionCoordinatorService()
+{
+    for(CoordinatorMap::iterator it = coordinators.begin(); it != coordinators.end(); ++it)
+    {
+        delete it->second.first;
+    }
+}
+
+ContentionCoordinator*
+ContentionCoordinatorService::attach(const std::string& channelName)
+{
+    CoordinatorMap::iterator it = coordinators.find(channelName);
+    if(it == coordinators.end())
+    {
+        MESSAGE_SINGLE(NORMAL, logger, "Create contention coordinator for channel " << channelName);
+        it = coordinators.insert(
+            std::make_pair(channelName,
+                           std::make_pair(new ContentionCoordinator(channelName), 0))).first;
+    }
+    ++(it->second.second);
+    return(it->second.first);
+}
+
+void
+ContentionCoordinatorService::detach(const std::string& channelName)
+{
+    CoordinatorMap::iterator it = coordinators.find(channelName);
+    assure(it != coordinators.end(), "Unknown channel " << channelName);
+
+    if(--(it->second.second) == 0)
+    {
+        MESSAGE_SINGLE(NORMAL, logger, "Delete contention coordinator for channel " << channelName);
+        delete it->second.first;
+        coordinators.erase(it);
+    }
+}
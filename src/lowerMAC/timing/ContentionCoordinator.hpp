@@ -0,0 +1,278 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_LOWERMAC_TIMING_CONTENTIONCOORDINATOR_HPP
+#define WIFIMAC_LOWERMAC_TIMING_CONTENTIONCOORDINATOR_HPP
+
+#include <WNS/events/CanTimeout.hpp>
+#include <WNS/logger/Logger.hpp>
+#include <WNS/simulator/Time.hpp>
+#include <WNS/Singleton.hpp>
+
+#include <vector>
+#include <map>
+#include <string>
+
+namespace wifimac { namespace convergence {
+    class ChannelStateNotification;
+} // convergence
+} // wifimac
+
+namespace wifimac { namespace lowerMAC { namespace timing {
+
+    /**
+     * @brief Shared timer for all backoff instances of one channel
+     *
+     * Instead of scheduling an own event for every AIFS and slot countdown,
+     * the backoff instances of a channel register their expiry times at the
+     * coordinator. The expiry times are kept in a binary heap, and only the
+     * earliest one is scheduled at the event scheduler. Hence, setting or
+     * cancelling the timeout of a client costs O(log N) for N clients, and a
+     * new scheduler event is required only if the earliest expiry changes.
+     *
+     * Clients with the same expiry time are notified in the order in which
+     * they have set their timeouts, as with individual events.
+     *
+     * The clients which observe the same channel state can also leave the
+     * channel busy/idle transitions to the coordinator. Such a carrier sense
+     * group observes the channel state once for all its members:
+     * - On a busy transition, all members are informed and a single timeout
+     *   of the group is set to the end of the busy detection delay.
+     * - When the delay has passed, all members freeze their countdowns and
+     *   their timeouts are removed from the heap.
+     * - On an idle transition, all members restart their countdowns.
+     * In each case, the event at the scheduler is adjusted only once after
+     * all members have been processed.
+     */
+    class ContentionCoordinator :
+        public wns::events::CanTimeout
+    {
+    public:
+        /**
+         * @brief Interface of the timer users
+         */
+        class Client
+        {
+            friend class ContentionCoordinator;
+        public:
+            Client():
+                heapPosition(-1)
+                {}
+
+            virtual
+            ~Client()
+                {}
+
+            /** @brief The timeout set at the coordinator has expired */
+            virtual void
+            onContentionTimeout() = 0;
+
+        private:
+            /** @brief Position in the heap of the coordinator, -1 if no timeout is set */
+            int heapPosition;
+        };
+
+        /**
+         * @brief Clients sharing the channel state of a carrier sense group
+         */
+        class CarrierSense;
+
+        /**
+         * @brief Interface of the timer users which get the channel state
+         * transitions from the coordinator
+         */
+        class CarrierSenseClient :
+            public Client
+        {
+            friend class ContentionCoordinator;
+        public:
+            CarrierSenseClient():
+                carrierSense(NULL)
+                {}
+
+            /** @brief The channel has become busy */
+            virtual void
+            onCarrierSenseBusy() = 0;
+
+            /**
+             * @brief The busy detection delay after a busy transition has passed
+             *
+             * Returns true if the countdown is frozen, the coordinator then
+             * removes the timeout of the client.
+             */
+            virtual bool
+            onCarrierSenseFreeze() = 0;
+
+            /** @brief The channel has become idle */
+            virtual void
+            onCarrierSenseIdle() = 0;
+
+        private:
+            /** @brief Group of the client, NULL if it has not joined one */
+            CarrierSense* carrierSense;
+        };
+
+        explicit
+        ContentionCoordinator(const std::string& channelName);
+
+        ~ContentionCoordinator();
+
+        /** @brief Set the timeout of the client, replaces a pending timeout */
+        void
+        setClientTimeout(Client* client, const wns::simulator::Time& delay);
+
+        /** @brief Cancel the pending timeout of the client */
+        void
+        cancelClientTimeout(Client* client);
+
+        bool
+        hasClientTimeout(const Client* client) const
+            {
+                return(client->heapPosition != -1);
+            }
+
+        /**
+         * @brief Add the client to the carrier sense group of the channel
+         * state, the group is created on first use
+         *
+         * A busy transition freezes the countdowns after busyDelay, the
+         * delay must be the same for all members of the group.
+         */
+        void
+        joinCarrierSense(CarrierSenseClient* client,
+                         wifimac::convergence::ChannelStateNotification* channelState,
+                         const wns::simulator::Time& busyDelay);
+
+        /** @brief Remove the client from its carrier sense group */
+        void
+        leaveCarrierSense(CarrierSenseClient* client);
+
+        bool
+        isInCarrierSense(const CarrierSenseClient* client) const
+            {
+                return(client->carrierSense != NULL);
+            }
+
+    private:
+        friend class CarrierSense;
+
+        typedef std::map<wifimac::convergence::ChannelStateNotification*, CarrierSense*> CarrierSenseMap;
+
+        struct Entry
+        {
+            wns::simulator::Time expiry;
+            unsigned long int sequence;
+            Client* client;
+        };
+
+        /** @brief implementation of CanTimeout interface */
+        void
+        onTimeout();
+
+        /** @brief Ordering of the heap: earlier expiry first, FIFO for equal expiries */
+        static bool
+        before(const Entry& a, const Entry& b)
+            {
+                return(a.expiry < b.expiry or
+                       (a.expiry == b.expiry and a.sequence < b.sequence));
+            }
+
+        void
+        place(const Entry& entry, int position);
+
+        void
+        siftUp(int position);
+
+        void
+        siftDown(int position);
+
+        void
+        removeAt(int position);
+
+        /** @brief Schedule the event for the earliest expiry */
+        void
+        rearm();
+
+        // channel state transitions of a carrier sense group
+        void
+        onCarrierSenseBusy(CarrierSense* group);
+
+        void
+        onCarrierSenseFreeze(CarrierSense* group);
+
+        void
+        onCarrierSenseIdle(CarrierSense* group);
+
+        wns::logger::Logger logger;
+
+        std::vector<Entry> heap;
+        unsigned long int sequence;
+
+        /** @brief Expiry the scheduled event belongs to */
+        wns::simulator::Time armedFor;
+
+        /** @brief Clients are notified, rescheduling is done afterwards */
+        bool notifying;
+
+        CarrierSenseMap carrierSenses;
+    };
+
+    /**
+     * @brief Access to the contention coordinators by channel name
+     *
+     * A coordinator exists as long as it has attached backoff instances.
+     */
+    class ContentionCoordinatorService
+    {
+    public:
+        ContentionCoordinatorService();
+
+        ~ContentionCoordinatorService();
+
+        /** @brief Coordinator of the channel, created on first use */
+        ContentionCoordinator*
+        attach(const std::string& channelName);
+
+        /** @brief Release the coordinator obtained by attach */
+        void
+        detach(const std::string& channelName);
+
+    private:
+        typedef std::map<std::string, std::pair<ContentionCoordinator*, int> > CoordinatorMap;
+
+        wns::logger::Logger logger;
+        CoordinatorMap coordinators;
+    };
+
+    typedef wns::SingletonHolder<ContentionCoordinatorService> TheContentionCoordinatorService;
+
+} // timing
+} // lowerMAC
+} // wifimac
+
+#endif // WIFIMAC_LOWERMAC_TIMING_CONTENTIONCOORDINATOR_HPP
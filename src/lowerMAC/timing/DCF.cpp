@@ -48,6 +48,7 @@ DCF::DCF(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& config_) :
     csName(config_.get<std::string>("csName")),
     rxStartEndName(config_.get<std::string>("rxStartEndName")),
     arqCommandName(config_.get<std::string>("arqCommandName")),
+    arqReader(NULL),
     backoffDisabled(config_.get<bool>("myConfig.backoffDisabled")),
     backoff(this, config_),
     sendNow(false),
@@ -63,10 +64,11 @@ DCF::~DCF()
 
 void DCF::onFUNCreated()
 {
+    arqReader = getFUN()->getCommandReader(arqCommandName);
     if(not backoffDisabled)
     {
         // backoff observes the channel state
-        backoff.wns::Observer<wifimac::convergence::IChannelState>::startObserving
+        backoff.startObservingChannelState
             (getFUN()->findFriend<wifimac::convergence::ChannelStateNotification*>(csName));
 
         // backoff gets notified of failed receptions
@@ -106,9 +108,9 @@ DCF::doIsAccepting(const wns::ldk::CompoundPtr& compound) const
     {
         return true;
     }
-    if(getFUN()->getCommandReader(arqCommandName)->commandIsActivated(compound->getCommandPool()))
+    if(arqReader->commandIsActivated(compound->getCommandPool()))
     {
-        int numTransmissions = getFUN()->getCommandReader(arqCommandName)->
+        int numTransmissions = arqReader->
             readCommand<wns::ldk::arq::ARQCommand>(compound->getCommandPool())->localTransmissionCounter;
         MESSAGE_SINGLE(NORMAL, logger, "Compound w activated arq command, transmission number " << numTransmissions);
         sendNow = backoff.transmissionRequest(numTransmissions);
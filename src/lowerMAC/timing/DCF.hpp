@@ -35,6 +35,7 @@
 
 #include <WNS/ldk/fu/Plain.hpp>
 #include <WNS/ldk/Command.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 
 namespace wifimac { namespace lowerMAC { namespace timing {
@@ -87,6 +88,7 @@ namespace wifimac { namespace lowerMAC { namespace timing {
         const std::string csName;
         const std::string rxStartEndName;
         const std::string arqCommandName;
+        wns::ldk::CommandReaderInterface* arqReader;
         const bool backoffDisabled;
 
         /** @brief The backoff instance */
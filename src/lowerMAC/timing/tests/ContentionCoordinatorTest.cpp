@@ -0,0 +1,499 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/lowerMAC/timing/tests/ContentionCoordinatorTest.hpp>
+
+#include <WNS/Assure.hpp>
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <map>
+
+using namespace wifimac::lowerMAC::timing::tests;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ContentionCoordinatorTest );
+
+ContentionCoordinatorTest::ContentionCoordinatorTest():
+    wns::TestFixture(),
+    coordinator(NULL),
+    clients(),
+    carrierSenseClients(),
+    log(),
+    slot(9e-6),
+    random()
+{
+}
+
+void ContentionCoordinatorTest::prepare()
+{
+    assure(this->coordinator == NULL, "not properly deleted");
+    assure(this->clients.empty(), "not properly deleted");
+    assure(this->carrierSenseClients.empty(), "not properly deleted");
+
+    this->coordinator = new ContentionCoordinator("test");
+    this->log.clear();
+    this->random.reset();
+}
+
+void ContentionCoordinatorTest::cleanup()
+{
+    for(std::vector<ClientMock*>::iterator it = this->clients.begin(); it != this->clients.end(); ++it)
+    {
+        if(this->coordinator->hasClientTimeout(*it))
+        {
+            this->coordinator->cancelClientTimeout(*it);
+        }
+        delete *it;
+    }
+    this->clients.clear();
+
+    for(std::vector<CarrierSenseClientMock*>::iterator it = this->carrierSenseClients.begin();
+        it != this->carrierSenseClients.end();
+        ++it)
+    {
+        if(this->coordinator->isInCarrierSense(*it))
+        {
+            this->coordinator->leaveCarrierSense(*it);
+        }
+        if(this->coordinator->hasClientTimeout(*it))
+        {
+            this->coordinator->cancelClientTimeout(*it);
+        }
+        delete *it;
+    }
+    this->carrierSenseClients.clear();
+
+    delete this->coordinator;
+    this->coordinator = NULL;
+}
+
+void ContentionCoordinatorTest::createClients(int numClients)
+{
+    for(int i = 0; i < numClients; ++i)
+    {
+        this->clients.push_back(new ClientMock(i, this->coordinator, &this->log));
+    }
+}
+
+void ContentionCoordinatorTest::createCarrierSenseClients(int numClients, int cs, wns::simulator::Time busyDelay)
+{
+    for(int i = 0; i < numClients; ++i)
+    {
+        CarrierSenseClientMock* client =
+            new CarrierSenseClientMock(this->carrierSenseClients.size(), this->coordinator, &this->log);
+        this->coordinator->joinCarrierSense(client, &this->channelStates[cs], busyDelay);
+        this->carrierSenseClients.push_back(client);
+    }
+}
+
+void ContentionCoordinatorTest::scheduleChannelState(int cs, wifimac::convergence::CS state, wns::simulator::Time delay)
+{
+    wns::simulator::getEventScheduler()->scheduleDelay(
+        boost::bind(&ChannelStateMock::setState, &this->channelStates[cs], state),
+        delay);
+}
+
+void ContentionCoordinatorTest::run()
+{
+    wns::simulator::getEventScheduler()->start();
+}
+
+void ContentionCoordinatorTest::assertExpiry(size_t position, int id, wns::simulator::Time time) const
+{
+    CPPUNIT_ASSERT(position < this->log.size());
+    CPPUNIT_ASSERT_EQUAL(id, this->log[position].first);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(time, this->log[position].second, 1e-12);
+}
+
+void ContentionCoordinatorTest::firingOrder()
+{
+    createClients(5);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    const int delays[5] = {5, 1, 3, 2, 4};
+    for(int i = 0; i < 5; ++i)
+    {
+        coordinator->setClientTimeout(clients[i], delays[i] * slot);
+        CPPUNIT_ASSERT(coordinator->hasClientTimeout(clients[i]));
+    }
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), log.size());
+    assertExpiry(0, 1, start + 1 * slot);
+    assertExpiry(1, 3, start + 2 * slot);
+    assertExpiry(2, 2, start + 3 * slot);
+    assertExpiry(3, 4, start + 4 * slot);
+    assertExpiry(4, 0, start + 5 * slot);
+    for(int i = 0; i < 5; ++i)
+    {
+        CPPUNIT_ASSERT(not coordinator->hasClientTimeout(clients[i]));
+    }
+}
+
+void ContentionCoordinatorTest::fifoForEqualExpiry()
+{
+    createClients(4);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    // equal expiries in the order of setting the timeouts
+    coordinator->setClientTimeout(clients[3], slot);
+    coordinator->setClientTimeout(clients[1], slot);
+    coordinator->setClientTimeout(clients[0], 2 * slot);
+    coordinator->setClientTimeout(clients[2], slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), log.size());
+    assertExpiry(0, 3, start + slot);
+    assertExpiry(1, 1, start + slot);
+    assertExpiry(2, 2, start + slot);
+    assertExpiry(3, 0, start + 2 * slot);
+}
+
+void ContentionCoordinatorTest::replaceTimeout()
+{
+    createClients(3);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->setClientTimeout(clients[1], 2 * slot);
+    coordinator->setClientTimeout(clients[2], 2 * slot);
+
+    // the earliest timeout is moved behind the others, a replaced timeout
+    // counts as set last for equal expiries
+    coordinator->setClientTimeout(clients[0], 2 * slot);
+    // the latest one is moved to the front
+    coordinator->setClientTimeout(clients[2], slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), log.size());
+    assertExpiry(0, 2, start + slot);
+    assertExpiry(1, 1, start + 2 * slot);
+    assertExpiry(2, 0, start + 2 * slot);
+}
+
+void ContentionCoordinatorTest::cancel()
+{
+    createClients(6);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    for(int i = 0; i < 6; ++i)
+    {
+        coordinator->setClientTimeout(clients[i], (i + 1) * slot);
+    }
+
+    // cancel the earliest, one in the middle and the latest
+    coordinator->cancelClientTimeout(clients[0]);
+    coordinator->cancelClientTimeout(clients[3]);
+    coordinator->cancelClientTimeout(clients[5]);
+    CPPUNIT_ASSERT(not coordinator->hasClientTimeout(clients[0]));
+    CPPUNIT_ASSERT(not coordinator->hasClientTimeout(clients[3]));
+    CPPUNIT_ASSERT(not coordinator->hasClientTimeout(clients[5]));
+    CPPUNIT_ASSERT(coordinator->hasClientTimeout(clients[1]));
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), log.size());
+    assertExpiry(0, 1, start + 2 * slot);
+    assertExpiry(1, 2, start + 3 * slot);
+    assertExpiry(2, 4, start + 5 * slot);
+
+    // cancelling the only timeout leaves no event behind
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->cancelClientTimeout(clients[0]);
+    run();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), log.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(start + 5 * slot, wns::simulator::getEventScheduler()->getTime(), 1e-12);
+}
+
+void ContentionCoordinatorTest::rearmFromCallback()
+{
+    createClients(2);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    clients[0]->numRearms = 2;
+    clients[0]->rearmDelay = 2 * slot;
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->setClientTimeout(clients[1], 2 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), log.size());
+    assertExpiry(0, 0, start + slot);
+    assertExpiry(1, 1, start + 2 * slot);
+    assertExpiry(2, 0, start + 3 * slot);
+    assertExpiry(3, 0, start + 5 * slot);
+    CPPUNIT_ASSERT(not coordinator->hasClientTimeout(clients[0]));
+}
+
+void ContentionCoordinatorTest::rearmWithoutDelayFromCallback()
+{
+    createClients(3);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    // a timeout set without delay while notifying is due in the same
+    // round, after the clients which are already due
+    clients[0]->numRearms = 1;
+    clients[0]->rearmDelay = 0;
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->setClientTimeout(clients[1], slot);
+    coordinator->setClientTimeout(clients[2], 2 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), log.size());
+    assertExpiry(0, 0, start + slot);
+    assertExpiry(1, 1, start + slot);
+    assertExpiry(2, 0, start + slot);
+    assertExpiry(3, 2, start + 2 * slot);
+}
+
+void ContentionCoordinatorTest::cancelFromCallback()
+{
+    createClients(4);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    // client 0 cancels a client due at the same time and the earliest of
+    // the remaining ones
+    clients[0]->cancelOnExpiry.push_back(clients[1]);
+    clients[0]->cancelOnExpiry.push_back(clients[2]);
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->setClientTimeout(clients[1], slot);
+    coordinator->setClientTimeout(clients[2], 2 * slot);
+    coordinator->setClientTimeout(clients[3], 3 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), log.size());
+    assertExpiry(0, 0, start + slot);
+    assertExpiry(1, 3, start + 3 * slot);
+
+    // cancelling the last pending timeout while notifying leaves no event
+    clients[0]->cancelOnExpiry.push_back(clients[1]);
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->setClientTimeout(clients[1], 4 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), log.size());
+    assertExpiry(2, 0, start + 4 * slot);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(start + 4 * slot, wns::simulator::getEventScheduler()->getTime(), 1e-12);
+}
+
+void ContentionCoordinatorTest::setOtherFromCallback()
+{
+    createClients(3);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    // client 0 moves the pending timeout of client 1 before the one of client 2
+    clients[0]->setOnExpiry = clients[1];
+    clients[0]->setOnExpiryDelay = slot;
+    coordinator->setClientTimeout(clients[0], slot);
+    coordinator->setClientTimeout(clients[1], 5 * slot);
+    coordinator->setClientTimeout(clients[2], 3 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), log.size());
+    assertExpiry(0, 0, start + slot);
+    assertExpiry(1, 1, start + 2 * slot);
+    assertExpiry(2, 2, start + 3 * slot);
+}
+
+void ContentionCoordinatorTest::randomOperations()
+{
+    const int numClients = 50;
+    createClients(numClients);
+
+    for(int round = 0; round < 10; ++round)
+    {
+        const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+        // expected expiry of each client, as number of slots and order of
+        // setting
+        std::map<int, std::pair<int, int> > expected;
+        for(int op = 0; op < 200; ++op)
+        {
+            const int id = random(numClients);
+            if(expected.find(id) != expected.end() and random(3) == 0)
+            {
+                coordinator->cancelClientTimeout(clients[id]);
+                expected.erase(id);
+            }
+            else
+            {
+                const int slots = 1 + random(10);
+                coordinator->setClientTimeout(clients[id], slots * slot);
+                expected[id] = std::make_pair(slots, op);
+            }
+        }
+        for(int id = 0; id < numClients; ++id)
+        {
+            CPPUNIT_ASSERT_EQUAL(expected.find(id) != expected.end(), coordinator->hasClientTimeout(clients[id]));
+        }
+
+        std::vector<std::pair<std::pair<int, int>, int> > order;
+        for(std::map<int, std::pair<int, int> >::const_iterator it = expected.begin(); it != expected.end(); ++it)
+        {
+            order.push_back(std::make_pair(it->second, it->first));
+        }
+        std::sort(order.begin(), order.end());
+
+        log.clear();
+        run();
+
+        CPPUNIT_ASSERT_EQUAL(order.size(), log.size());
+        for(size_t i = 0; i < order.size(); ++i)
+        {
+            assertExpiry(i, order[i].second, start + order[i].first.first * slot);
+        }
+    }
+}
+
+void ContentionCoordinatorTest::carrierSenseFreeze()
+{
+    // clients 0, 1 share channel state 0, client 2 has channel state 1, the
+    // plain client 0 has none
+    createCarrierSenseClients(2, 0, slot / 2);
+    createCarrierSenseClients(1, 1, slot / 2);
+    createClients(1);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    for(int i = 0; i < 3; ++i)
+    {
+        carrierSenseClients[i]->idleDelay = 3 * slot;
+        coordinator->setClientTimeout(carrierSenseClients[i], 4 * slot);
+    }
+    coordinator->setClientTimeout(clients[0], 4 * slot);
+
+    // only the group of channel state 0 is frozen
+    scheduleChannelState(0, wifimac::convergence::busy, slot);
+    scheduleChannelState(0, wifimac::convergence::idle, 2 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(1, carrierSenseClients[0]->numFrozen);
+    CPPUNIT_ASSERT_EQUAL(1, carrierSenseClients[1]->numFrozen);
+    CPPUNIT_ASSERT_EQUAL(0, carrierSenseClients[2]->numFrozen);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), log.size());
+    assertExpiry(0, 2, start + 4 * slot);
+    assertExpiry(1, 0, start + 4 * slot);
+    assertExpiry(2, 0, start + 5 * slot);
+    assertExpiry(3, 1, start + 5 * slot);
+}
+
+void ContentionCoordinatorTest::carrierSenseShortBusy()
+{
+    createCarrierSenseClients(2, 0, slot / 2);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    for(int i = 0; i < 2; ++i)
+    {
+        carrierSenseClients[i]->idleDelay = 3 * slot;
+        coordinator->setClientTimeout(carrierSenseClients[i], 4 * slot);
+    }
+
+    // idle again before the busy delay has passed: no freeze, but the
+    // timeouts are restarted
+    scheduleChannelState(0, wifimac::convergence::busy, slot);
+    scheduleChannelState(0, wifimac::convergence::idle, 1.25 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(0, carrierSenseClients[0]->numFrozen);
+    CPPUNIT_ASSERT_EQUAL(0, carrierSenseClients[1]->numFrozen);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), log.size());
+    assertExpiry(0, 0, start + 4.25 * slot);
+    assertExpiry(1, 1, start + 4.25 * slot);
+}
+
+void ContentionCoordinatorTest::carrierSenseBusyWithinDelay()
+{
+    createCarrierSenseClients(2, 0, slot / 2);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    for(int i = 0; i < 2; ++i)
+    {
+        carrierSenseClients[i]->idleDelay = 0.625 * slot;
+        coordinator->setClientTimeout(carrierSenseClients[i], 4 * slot);
+    }
+
+    // Every busy transition is detected after its own delay: The freeze at
+    // 1.5 slots finds the channel idle, the one of the second transition at
+    // 1.875 slots freezes the timeouts set at 1.375 slots. Detecting the
+    // third transition only would let them expire at 2 slots.
+    scheduleChannelState(0, wifimac::convergence::busy, slot);
+    scheduleChannelState(0, wifimac::convergence::idle, 1.25 * slot);
+    scheduleChannelState(0, wifimac::convergence::busy, 1.375 * slot);
+    scheduleChannelState(0, wifimac::convergence::idle, 1.375 * slot);
+    scheduleChannelState(0, wifimac::convergence::busy, 1.625 * slot);
+    scheduleChannelState(0, wifimac::convergence::idle, 3 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(1, carrierSenseClients[0]->numFrozen);
+    CPPUNIT_ASSERT_EQUAL(1, carrierSenseClients[1]->numFrozen);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), log.size());
+    assertExpiry(0, 0, start + 3.625 * slot);
+    assertExpiry(1, 1, start + 3.625 * slot);
+}
+
+void ContentionCoordinatorTest::carrierSenseLeave()
+{
+    createCarrierSenseClients(2, 0, slot / 2);
+    const wns::simulator::Time start = wns::simulator::getEventScheduler()->getTime();
+
+    for(int i = 0; i < 2; ++i)
+    {
+        carrierSenseClients[i]->idleDelay = 3 * slot;
+        coordinator->setClientTimeout(carrierSenseClients[i], 4 * slot);
+    }
+
+    // client 0 does not get the transitions after leaving
+    coordinator->leaveCarrierSense(carrierSenseClients[0]);
+    CPPUNIT_ASSERT(not coordinator->isInCarrierSense(carrierSenseClients[0]));
+    CPPUNIT_ASSERT(coordinator->isInCarrierSense(carrierSenseClients[1]));
+
+    scheduleChannelState(0, wifimac::convergence::busy, slot);
+    scheduleChannelState(0, wifimac::convergence::idle, 2 * slot);
+    run();
+
+    CPPUNIT_ASSERT_EQUAL(0, carrierSenseClients[0]->numFrozen);
+    CPPUNIT_ASSERT_EQUAL(1, carrierSenseClients[1]->numFrozen);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), log.size());
+    assertExpiry(0, 0, start + 4 * slot);
+    assertExpiry(1, 1, start + 5 * slot);
+
+    // the last client deletes the group including its pending busy delay
+    scheduleChannelState(0, wifimac::convergence::busy, slot);
+    coordinator->setClientTimeout(carrierSenseClients[1], 4 * slot);
+    wns::simulator::getEventScheduler()->scheduleDelay(
+        boost::bind(&ContentionCoordinator::leaveCarrierSense, coordinator, carrierSenseClients[1]),
+        1.25 * slot);
+    run();
+
+    CPPUNIT_ASSERT(not coordinator->isInCarrierSense(carrierSenseClients[1]));
+    CPPUNIT_ASSERT_EQUAL(1, carrierSenseClients[1]->numFrozen);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), log.size());
+    assertExpiry(2, 1, start + 9 * slot);
+}
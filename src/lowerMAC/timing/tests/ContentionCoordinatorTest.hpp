@@ -0,0 +1,244 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_LOWERMAC_TIMING_TESTS_CONTENTIONCOORDINATORTEST_HPP
+#define WIFIMAC_LOWERMAC_TIMING_TESTS_CONTENTIONCOORDINATORTEST_HPP
+
+#include <WIFIMAC/lowerMAC/timing/ContentionCoordinator.hpp>
+#include <WIFIMAC/convergence/IChannelState.hpp>
+
+#include <WIFIMAC/helper/tests/Random.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+#include <vector>
+#include <utility>
+
+namespace wifimac { namespace lowerMAC { namespace timing { namespace tests {
+
+    class ContentionCoordinatorTest:
+        public wns::TestFixture
+    {
+        CPPUNIT_TEST_SUITE( ContentionCoordinatorTest );
+        CPPUNIT_TEST( firingOrder );
+        CPPUNIT_TEST( fifoForEqualExpiry );
+        CPPUNIT_TEST( replaceTimeout );
+        CPPUNIT_TEST( cancel );
+        CPPUNIT_TEST( rearmFromCallback );
+        CPPUNIT_TEST( rearmWithoutDelayFromCallback );
+        CPPUNIT_TEST( cancelFromCallback );
+        CPPUNIT_TEST( setOtherFromCallback );
+        CPPUNIT_TEST( randomOperations );
+        CPPUNIT_TEST( carrierSenseFreeze );
+        CPPUNIT_TEST( carrierSenseShortBusy );
+        CPPUNIT_TEST( carrierSenseBusyWithinDelay );
+        CPPUNIT_TEST( carrierSenseLeave );
+        CPPUNIT_TEST_SUITE_END();
+
+        /** @brief Client id and time of each expiry */
+        typedef std::vector<std::pair<int, wns::simulator::Time> > ExpiryLog;
+
+        class ClientMock :
+            public ContentionCoordinator::Client
+        {
+        public:
+            ClientMock(int _id, ContentionCoordinator* _coordinator, ExpiryLog* _log):
+                id(_id),
+                coordinator(_coordinator),
+                log(_log),
+                numRearms(0),
+                rearmDelay(0),
+                cancelOnExpiry(),
+                setOnExpiry(NULL),
+                setOnExpiryDelay(0)
+                {
+                }
+
+            virtual void onContentionTimeout()
+                {
+                    log->push_back(std::make_pair(id, wns::simulator::getEventScheduler()->getTime()));
+
+                    for(std::vector<ClientMock*>::iterator it = cancelOnExpiry.begin();
+                        it != cancelOnExpiry.end();
+                        ++it)
+                    {
+                        coordinator->cancelClientTimeout(*it);
+                    }
+                    cancelOnExpiry.clear();
+
+                    if(setOnExpiry != NULL)
+                    {
+                        coordinator->setClientTimeout(setOnExpiry, setOnExpiryDelay);
+                        setOnExpiry = NULL;
+                    }
+
+                    if(numRearms > 0)
+                    {
+                        --numRearms;
+                        coordinator->setClientTimeout(this, rearmDelay);
+                    }
+                }
+
+            const int id;
+            ContentionCoordinator* coordinator;
+            ExpiryLog* log;
+
+            // actions on expiry
+
+            /** @brief Set the own timeout again, numRearms times */
+            int numRearms;
+            wns::simulator::Time rearmDelay;
+
+            /** @brief Cancel the timeouts of these clients once */
+            std::vector<ClientMock*> cancelOnExpiry;
+
+            /** @brief Set the timeout of this client once */
+            ClientMock* setOnExpiry;
+            wns::simulator::Time setOnExpiryDelay;
+        };
+
+        /**
+         * @brief Backoff-like client: Frozen after the busy delay, the
+         * timeout is set again on idle
+         */
+        class CarrierSenseClientMock :
+            public ContentionCoordinator::CarrierSenseClient
+        {
+        public:
+            CarrierSenseClientMock(int _id, ContentionCoordinator* _coordinator, ExpiryLog* _log):
+                id(_id),
+                coordinator(_coordinator),
+                log(_log),
+                idleDelay(0),
+                busy(false),
+                numFrozen(0)
+                {
+                }
+
+            virtual void onContentionTimeout()
+                {
+                    log->push_back(std::make_pair(id, wns::simulator::getEventScheduler()->getTime()));
+                }
+
+            virtual void onCarrierSenseBusy()
+                {
+                    busy = true;
+                }
+
+            virtual bool onCarrierSenseFreeze()
+                {
+                    if(busy and coordinator->hasClientTimeout(this))
+                    {
+                        ++numFrozen;
+                        return true;
+                    }
+                    return false;
+                }
+
+            virtual void onCarrierSenseIdle()
+                {
+                    busy = false;
+                    coordinator->setClientTimeout(this, idleDelay);
+                }
+
+            const int id;
+            ContentionCoordinator* coordinator;
+            ExpiryLog* log;
+
+            /** @brief Timeout set on every idle transition */
+            wns::simulator::Time idleDelay;
+
+            bool busy;
+            int numFrozen;
+        };
+
+        /** @brief Channel state whose transitions are triggered by the test */
+        class ChannelStateMock :
+            public wifimac::convergence::ChannelStateNotification
+        {
+        public:
+            void setState(wifimac::convergence::CS cs)
+                {
+                    this->forEachObserver(OnChangedCS(cs));
+                }
+        };
+
+        ContentionCoordinator* coordinator;
+        std::vector<ClientMock*> clients;
+        std::vector<CarrierSenseClientMock*> carrierSenseClients;
+        ExpiryLog log;
+
+        ChannelStateMock channelStates[2];
+
+        const wns::simulator::Time slot;
+
+    public:
+        ContentionCoordinatorTest();
+
+    private:
+        virtual void prepare();
+        virtual void cleanup();
+
+        // the tests
+        void firingOrder();
+        void fifoForEqualExpiry();
+        void replaceTimeout();
+        void cancel();
+        void rearmFromCallback();
+        void rearmWithoutDelayFromCallback();
+        void cancelFromCallback();
+        void setOtherFromCallback();
+        void randomOperations();
+        void carrierSenseFreeze();
+        void carrierSenseShortBusy();
+        void carrierSenseBusyWithinDelay();
+        void carrierSenseLeave();
+
+        // support functions
+        void createClients(int numClients);
+
+        /** @brief Clients which joined the carrier sense group of channel state cs */
+        void createCarrierSenseClients(int numClients, int cs, wns::simulator::Time busyDelay);
+
+        /** @brief Change the state of the channel state cs after delay */
+        void scheduleChannelState(int cs, wifimac::convergence::CS state, wns::simulator::Time delay);
+
+        /** @brief Process all events of the scheduler */
+        void run();
+
+        void assertExpiry(size_t position, int id, wns::simulator::Time time) const;
+
+        wifimac::helper::tests::Random random;
+    };
+
+} // tests
+} // timing
+} // lowerMAC
+} // wifimac
+
+#endif // WIFIMAC_LOWERMAC_TIMING_TESTS_CONTENTIONCOORDINATORTEST_HPP
@@ -47,6 +47,7 @@ Beacon::Beacon(wns::ldk::fun::FUN* fun, const wns::pyconfig::View& config_) :
     logger(config.get("logger")),
     currentBeacon(),
     phyUserCommandName(config.get<std::string>("phyUserCommandName")),
+    phyUserReader(NULL),
     scanFrequencies(config.getSequence("myConfig.scanFrequencies")),
     beaconPhyMode(config.getView("myConfig.beaconPhyMode")),
     bssId(config.get<std::string>("myConfig.bssId")),
@@ -65,6 +66,7 @@ Beacon::~Beacon()
 void
 Beacon::onFUNCreated()
 {
+    phyUserReader = getFUN()->getCommandReader(phyUserCommandName);
     friends.manager = getFUN()->findFriend<wifimac::lowerMAC::Manager*>(config.get<std::string>("managerName"));
     assure(friends.manager, "Management entity not found");
 
@@ -110,7 +112,7 @@ void Beacon::processIncoming(const wns::ldk::CompoundPtr& compound)
         if(this->bssId.compare(getCommand(compound->getCommandPool())->peer.bssId) == 0)
         {
             wifimac::convergence::PhyUserCommand* puc =
-                getFUN()->getCommandReader(phyUserCommandName)->readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool());
+                phyUserReader->readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool());
             beaconRxStrength[puc->local.rxPower + puc->local.interference] = friends.manager->getTransmitterAddress(compound->getCommandPool());
             bssFrequencies[friends.manager->getTransmitterAddress(compound->getCommandPool())] = *freqIter;
             MESSAGE_BEGIN(NORMAL, this->logger, m, "Received Beacon from ");
@@ -43,6 +43,7 @@
 #include <WNS/service/dll/Address.hpp>
 #include <WNS/PowerRatio.hpp>
 #include <WNS/pyconfig/Sequence.hpp>
+#include <WNS/ldk/CommandReaderInterface.hpp>
 
 #include <map>
 
@@ -121,6 +122,7 @@ namespace wifimac { namespace management {
         wns::ldk::CompoundPtr currentBeacon;
 
 		const std::string phyUserCommandName;
+		wns::ldk::CommandReaderInterface* phyUserReader;
 
 		/**
 		 * @brief How long shall a STA scan for beacons before it associates to one?
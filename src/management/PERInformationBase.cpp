@@ -55,15 +55,38 @@ PERInformationBase::onMSRCreated()
     MESSAGE_SINGLE(NORMAL, logger, "Created.");
 }
 
+PERInformationBase::PeerStatistics&
+PERInformationBase::getPeer(const wns::service::dll::UnicastAddress receiver)
+{
+    PeerStatisticsMap::iterator it = peers.find(receiver.getInteger());
+    if(it == peers.end())
+    {
+        it = peers.insert(std::make_pair(receiver.getInteger(), PeerStatistics(windowSize))).first;
+    }
+    return(it->second);
+}
+
+PERInformationBase::PeerStatistics*
+PERInformationBase::findPeer(const wns::service::dll::UnicastAddress receiver) const
+{
+    PeerStatisticsMap::iterator it = peers.find(receiver.getInteger());
+    if(it == peers.end())
+    {
+        return(NULL);
+    }
+    return(&(it->second));
+}
+
 void PERInformationBase::reset(const wns::service::dll::UnicastAddress receiver)
 {
     assure(receiver.isValid(), "address is not valid");
 
-    if(perHolder.knows(receiver))
+    PeerStatistics* peer = findPeer(receiver);
+    if(peer != NULL)
     {
-        perHolder.find(receiver)->reset();
-        successfull.find(receiver) = 0;
-        failed.find(receiver) = 0;
+        peer->perWindow.reset();
+        peer->successfull = 0;
+        peer->failed = 0;
     }
 }
 
@@ -71,14 +94,9 @@ void PERInformationBase::onSuccessfullTransmission(const wns::service::dll::Unic
 {
     assure(receiver.isValid(), "address is not valid");
 
-    if(!perHolder.knows(receiver))
-    {
-        perHolder.insert(receiver, new wns::SlidingWindow(windowSize));
-        successfull.insert(receiver, 0);
-        failed.insert(receiver, 0);
-    }
-    perHolder.find(receiver)->put(0.0);
-    ++(successfull.find(receiver));
+    PeerStatistics& peer = getPeer(receiver);
+    peer.perWindow.put(0.0);
+    ++peer.successfull;
 }
 
 
@@ -86,23 +104,19 @@ void PERInformationBase::onFailedTransmission(const wns::service::dll::UnicastAd
 {
     assure(receiver.isValid(), "address is not valid");
 
-    if(!perHolder.knows(receiver))
-    {
-        perHolder.insert(receiver, new wns::SlidingWindow(windowSize));
-        successfull.insert(receiver, 0);
-        failed.insert(receiver, 0);
-    }
-    perHolder.find(receiver)->put(1.0);
-    ++(failed.find(receiver));
+    PeerStatistics& peer = getPeer(receiver);
+    peer.perWindow.put(1.0);
+    ++peer.failed;
 }
 
 bool PERInformationBase::knowsPER(const wns::service::dll::UnicastAddress receiver) const
 {
     assure(receiver.isValid(), "address is not valid");
 
-    if(perHolder.knows(receiver))
+    PeerStatistics* peer = findPeer(receiver);
+    if(peer != NULL)
     {
-        return(perHolder.find(receiver)->getNumSamples() >= minSamples);
+        return(peer->perWindow.getNumSamples() >= minSamples);
     }
     else
     {
@@ -114,25 +128,29 @@ double PERInformationBase::getPER(const wns::service::dll::UnicastAddress receiv
 {
     assure(receiver.isValid(), "address is not valid");
 
-    assure(knowsPER(receiver), "Success rate for destination " << receiver << " not known");
-    return(perHolder.find(receiver)->getAbsolute() / perHolder.find(receiver)->getNumSamples());
+    PeerStatistics* peer = findPeer(receiver);
+    assure(peer != NULL and peer->perWindow.getNumSamples() >= minSamples,
+           "Success rate for destination " << receiver << " not known");
+    return(peer->perWindow.getAbsolute() / peer->perWindow.getNumSamples());
 }
 
 
 int PERInformationBase::getSuccessfull(const wns::service::dll::UnicastAddress receiver) const
 {
-    if(not successfull.knows(receiver))
+    PeerStatistics* peer = findPeer(receiver);
+    if(peer == NULL)
     {
         return 0;
     }
-    return successfull.find(receiver);
+    return peer->successfull;
 }
 
 int PERInformationBase::getFailed(const wns::service::dll::UnicastAddress receiver) const
 {
-    if(not failed.knows(receiver))
+    PeerStatistics* peer = findPeer(receiver);
+    if(peer == NULL)
     {
         return 0;
     }
-    return failed.find(receiver);
+    return peer->failed;
 }
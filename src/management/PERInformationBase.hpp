@@ -36,6 +36,8 @@
 #include <WNS/service/dll/Address.hpp>
 #include <WNS/ldk/arq/statuscollector/Interface.hpp>
 
+#include <boost/unordered_map.hpp>
+
 namespace wifimac { namespace management {
 
     /**
@@ -92,12 +94,38 @@ namespace wifimac { namespace management {
         void
         onMSRCreated();
 
-        /** @brief Holder type of the sliding windows for the targets */
-        typedef wns::container::Registry<wns::service::dll::UnicastAddress, wns::SlidingWindow*> slidingWindowMap;
-        typedef wns::container::Registry<wns::service::dll::UnicastAddress, int> intMap;
+        /** @brief All statistics of the link to one target */
+        struct PeerStatistics
+        {
+            PeerStatistics(const simTimeType windowSize):
+                perWindow(windowSize),
+                successfull(0),
+                failed(0)
+                {}
+
+            /** @brief Sliding window for averaging the PER */
+            wns::SlidingWindow perWindow;
+            int successfull;
+            int failed;
+        };
+
+        /** @brief Holder type of the statistics, by target address integer */
+        typedef boost::unordered_map<int, PeerStatistics> PeerStatisticsMap;
 
-        /** @brief Holder of the sliding windows, one for each target */
-        slidingWindowMap perHolder;
+        /** @brief Returns the statistics of the target, created on first use */
+        PeerStatistics&
+        getPeer(const wns::service::dll::UnicastAddress target);
+
+        /** @brief Returns the statistics of the target or NULL if unknown */
+        PeerStatistics*
+        findPeer(const wns::service::dll::UnicastAddress target) const;
+
+        /**
+         * @brief Holder of the statistics, one for each target
+         *
+         * Mutable as reading a sliding window purges its outdated samples
+         */
+        mutable PeerStatisticsMap peers;
 
         /** @brief The logger */
         wns::logger::Logger logger;
@@ -108,9 +136,6 @@ namespace wifimac { namespace management {
         /** @brief The minimum number of samples in the sliding window so that
          * an average can be computed */
         const int minSamples;
-
-        intMap successfull;
-        intMap failed;
     };
 } // management
 } // wifimac
@@ -40,7 +40,7 @@ ProtocolCalculator::ProtocolCalculator( wns::ldk::ManagementServiceRegistry* msr
     logger(config_.get("logger")),
     config(config_)
 {
-    errorProbability = new protocolCalculatorPlugins::ErrorProbability();
+    errorProbability = new protocolCalculatorPlugins::ErrorProbability(config_.get<wns::pyconfig::View>("myConfig.errorProbability"));
     frameLength = new protocolCalculatorPlugins::FrameLength(config_.get<wns::pyconfig::View>("myConfig.frameLength"));
     duration = new protocolCalculatorPlugins::Duration(frameLength, config_.get<wns::pyconfig::View>("myConfig.duration"));
 }
@@ -50,6 +50,28 @@ SINRInformationBase::onMSRCreated()
     MESSAGE_SINGLE(NORMAL, logger, "Created.");
 }
 
+SINRInformationBase::PeerSINR&
+SINRInformationBase::getPeer(const wns::service::dll::UnicastAddress peer)
+{
+    PeerSINRMap::iterator it = peers.find(peer.getInteger());
+    if(it == peers.end())
+    {
+        it = peers.insert(std::make_pair(peer.getInteger(), PeerSINR(windowSize))).first;
+    }
+    return(it->second);
+}
+
+SINRInformationBase::PeerSINR*
+SINRInformationBase::findPeer(const wns::service::dll::UnicastAddress peer)
+{
+    PeerSINRMap::iterator it = peers.find(peer.getInteger());
+    if(it == peers.end())
+    {
+        return(NULL);
+    }
+    return(&(it->second));
+}
+
 void
 SINRInformationBase::putMeasurement(const wns::service::dll::UnicastAddress tx,
                                     const wns::Ratio sinr,
@@ -57,20 +79,13 @@ SINRInformationBase::putMeasurement(const wns::service::dll::UnicastAddress tx,
 {
     assure(tx.isValid(), "Address is not valid");
 
-    if(!measuredSINRHolder.knows(tx))
-    {
-        measuredSINRHolder.insert(tx, new wns::SlidingWindow(windowSize));
-    }
-    measuredSINRHolder.find(tx)->put(sinr.get_dB());
+    PeerSINR& info = getPeer(tx);
+    info.measuredSINR.put(sinr.get_dB());
 
     if(estimatedValidity > 0.0)
     {
-        if(not lastMeasurement.knows(tx))
-        {
-            lastMeasurement.insert(tx, new ratioTimePair);
-        }
-        lastMeasurement.find(tx)->first = sinr;
-        lastMeasurement.find(tx)->second = wns::simulator::getEventScheduler()->getTime() + estimatedValidity;
+        info.lastMeasurement.first = sinr;
+        info.lastMeasurement.second = wns::simulator::getEventScheduler()->getTime() + estimatedValidity;
     }
 }
 
@@ -79,20 +94,18 @@ SINRInformationBase::knowsMeasuredSINR(const wns::service::dll::UnicastAddress t
 {
     assure(tx.isValid(), "Address is not valid");
 
-    if(lastMeasurement.knows(tx) and
-       (lastMeasurement.find(tx)->second > wns::simulator::getEventScheduler()->getTime()))
+    PeerSINR* info = findPeer(tx);
+    if(info == NULL)
     {
-        return true;
+        return(false);
     }
 
-    if(measuredSINRHolder.knows(tx))
-    {
-        return(measuredSINRHolder.find(tx)->getNumSamples() > 0);
-    }
-    else
+    if(info->lastMeasurement.second > wns::simulator::getEventScheduler()->getTime())
     {
-        return(false);
+        return true;
     }
+
+    return(info->measuredSINR.getNumSamples() > 0);
 }
 
 wns::Ratio
@@ -100,12 +113,12 @@ SINRInformationBase::getMeasuredSINR(const wns::service::dll::UnicastAddress tx)
 {
     assure(this->knowsMeasuredSINR(tx), "SINR for transmitter " << tx << " not known");
 
-    if(lastMeasurement.knows(tx) and
-       (lastMeasurement.find(tx)->second > wns::simulator::getEventScheduler()->getTime()))
+    PeerSINR* info = findPeer(tx);
+    if(info->lastMeasurement.second > wns::simulator::getEventScheduler()->getTime())
     {
-        return lastMeasurement.find(tx)->first;
+        return info->lastMeasurement.first;
     }
-    return(wns::Ratio::from_dB(measuredSINRHolder.find(tx)->getAbsolute() / measuredSINRHolder.find(tx)->getNumSamples()));
+    return(wns::Ratio::from_dB(info->measuredSINR.getAbsolute() / info->measuredSINR.getNumSamples()));
 }
 
 void
@@ -115,23 +128,14 @@ SINRInformationBase::putPeerSINR(const wns::service::dll::UnicastAddress peer,
 {
     assure(peer.isValid(), "Address is not valid");
 
-    if(!peerSINRHolder.knows(peer))
-    {
-        peerSINRHolder.insert(peer, new wns::Ratio(sinr));
-    }
-    else
-    {
-        *(peerSINRHolder.find(peer)) = sinr;
-    }
+    PeerSINR& info = getPeer(peer);
+    info.peerSINR = sinr;
+    info.hasPeerSINR = true;
 
     if(estimatedValidity > 0.0)
     {
-        if(not lastPeerMeasurement.knows(peer))
-        {
-            lastPeerMeasurement.insert(peer, new ratioTimePair);
-        }
-        lastPeerMeasurement.find(peer)->first = sinr;
-        lastPeerMeasurement.find(peer)->second = wns::simulator::getEventScheduler()->getTime() + estimatedValidity;
+        info.lastPeerMeasurement.first = sinr;
+        info.lastPeerMeasurement.second = wns::simulator::getEventScheduler()->getTime() + estimatedValidity;
     }
 }
 
@@ -140,19 +144,24 @@ SINRInformationBase::knowsPeerSINR(const wns::service::dll::UnicastAddress peer)
 {
     assure(peer.isValid(), "Address is not valid");
 
-    if(fakePeerMeasurement.knows(peer) and
-       (fakePeerMeasurement.find(peer)->second == wns::simulator::getEventScheduler()->getTime()))
+    PeerSINR* info = findPeer(peer);
+    if(info == NULL)
+    {
+        return(false);
+    }
+
+    wns::simulator::Time now = wns::simulator::getEventScheduler()->getTime();
+    if(info->fakePeerMeasurement.second == now)
     {
         return true;
     }
 
-    if(lastPeerMeasurement.knows(peer) and
-       (lastPeerMeasurement.find(peer)->second > wns::simulator::getEventScheduler()->getTime()))
+    if(info->lastPeerMeasurement.second > now)
     {
         return true;
     }
 
-    return(peerSINRHolder.knows(peer));
+    return(info->hasPeerSINR);
 }
 
 wns::Ratio
@@ -160,32 +169,26 @@ SINRInformationBase::getPeerSINR(const wns::service::dll::UnicastAddress peer)
 {
     assure(this->knowsPeerSINR(peer), "peerSINR for " << peer << " is not known");
 
-    if(fakePeerMeasurement.knows(peer) and
-       (fakePeerMeasurement.find(peer)->second == wns::simulator::getEventScheduler()->getTime()))
+    PeerSINR* info = findPeer(peer);
+    wns::simulator::Time now = wns::simulator::getEventScheduler()->getTime();
+    if(info->fakePeerMeasurement.second == now)
     {
-        return fakePeerMeasurement.find(peer)->first;
+        return info->fakePeerMeasurement.first;
     }
 
-    if(lastPeerMeasurement.knows(peer) and
-       (lastPeerMeasurement.find(peer)->second > wns::simulator::getEventScheduler()->getTime()))
+    if(info->lastPeerMeasurement.second > now)
     {
-        return lastPeerMeasurement.find(peer)->first;
+        return info->lastPeerMeasurement.first;
     }
 
-    return(*(peerSINRHolder.find(peer)));
+    return(info->peerSINR);
 }
 
 void
 SINRInformationBase::putFakePeerSINR(const wns::service::dll::UnicastAddress peer,
                                      const wns::Ratio sinr)
 {
-    if(not fakePeerMeasurement.knows(peer))
-    {
-        fakePeerMeasurement.insert(peer, new ratioTimePair);
-    }
-    fakePeerMeasurement.find(peer)->first = sinr;
-    fakePeerMeasurement.find(peer)->second = wns::simulator::getEventScheduler()->getTime();
-
-
+    PeerSINR& info = getPeer(peer);
+    info.fakePeerMeasurement.first = sinr;
+    info.fakePeerMeasurement.second = wns::simulator::getEventScheduler()->getTime();
 }
-
@@ -37,6 +37,7 @@
 #include <WNS/service/dll/Address.hpp>
 #include <WNS/simulator/Time.hpp>
 
+#include <boost/unordered_map.hpp>
 #include <utility>
 
 
@@ -127,29 +128,51 @@ namespace wifimac { namespace management {
         void
         onMSRCreated();
 
-        /** @brief Measurement holder type: Maps address to sliding window */
-        typedef wns::container::Registry<wns::service::dll::UnicastAddress, wns::SlidingWindow*, wns::container::registry::DeleteOnErase> slidingWindowMap;
-
-        /** @brief Holds SINR values measured here */
-        slidingWindowMap measuredSINRHolder;
-
-        /** @brief SINR information holder type: Maps peer address to SINR */
-        typedef wns::container::Registry<wns::service::dll::UnicastAddress, wns::Ratio*> ratioMap;
-
-        /** @brief Holds SINR values received by peers */
-        ratioMap peerSINRHolder;
-
         typedef std::pair<wns::Ratio, wns::simulator::Time> ratioTimePair;
-        typedef wns::container::Registry<wns::service::dll::UnicastAddress, ratioTimePair*> ratioWithTimeMap;
-
-        /** @brief Holds the last SINR measurement */
-        ratioWithTimeMap lastMeasurement;
-
-        /** @brief Holds the last received peer SINR measurement */
-        ratioWithTimeMap lastPeerMeasurement;
 
-        /** @brief Holds fake peer measurements */
-        ratioWithTimeMap fakePeerMeasurement;
+        /** @brief All SINR information about the link with one peer */
+        struct PeerSINR
+        {
+            PeerSINR(const simTimeType windowSize):
+                measuredSINR(windowSize),
+                hasPeerSINR(false),
+                peerSINR(),
+                // the times are set such that nothing is valid initially
+                lastMeasurement(wns::Ratio(), -1.0),
+                lastPeerMeasurement(wns::Ratio(), -1.0),
+                fakePeerMeasurement(wns::Ratio(), -1.0)
+                {}
+
+            /** @brief SINR values measured here */
+            wns::SlidingWindow measuredSINR;
+
+            /** @brief SINR value received by the peer */
+            bool hasPeerSINR;
+            wns::Ratio peerSINR;
+
+            /** @brief The last SINR measurement and its validity */
+            ratioTimePair lastMeasurement;
+
+            /** @brief The last received peer SINR measurement and its validity */
+            ratioTimePair lastPeerMeasurement;
+
+            /** @brief Fake peer measurement and the time it was set */
+            ratioTimePair fakePeerMeasurement;
+        };
+
+        /** @brief Holder type of the peer information, by address integer */
+        typedef boost::unordered_map<int, PeerSINR> PeerSINRMap;
+
+        /** @brief Returns the information of the peer, created on first use */
+        PeerSINR&
+        getPeer(const wns::service::dll::UnicastAddress peer);
+
+        /** @brief Returns the information of the peer or NULL if unknown */
+        PeerSINR*
+        findPeer(const wns::service::dll::UnicastAddress peer);
+
+        /** @brief Holds the SINR information, one for each peer */
+        PeerSINRMap peers;
 
         /** @brief The logger */
         wns::logger::Logger logger;
@@ -35,7 +35,9 @@ Duration::Duration( FrameLength* fl_, const wns::pyconfig::View& config):
     symbolWithoutGI(config.get<wns::simulator::Time>("symbolDurationWithoutGI")),
     slot(config.get<wns::simulator::Time>("slot")),
     sifs(config.get<wns::simulator::Time>("sifs")),
-    fl(fl_)
+    fl(fl_),
+    timingCache(),
+    lastTiming(timingCache.end())
 {
 
 }
@@ -44,24 +46,96 @@ Duration::Duration( FrameLength* fl_, const ConfigGetter& config ):
     symbolWithoutGI(config.get<wns::simulator::Time>("symbolDurationWithoutGI", "d")),
     slot(config.get<wns::simulator::Time>("slot", "d")),
     sifs(config.get<wns::simulator::Time>("sifs", "d")),
-    fl(fl_)
+    fl(fl_),
+    timingCache(),
+    lastTiming(timingCache.end())
 {
 
 }
 
+Duration::TimingKey::TimingKey(const wifimac::convergence::PhyMode& pm):
+    streams(pm.getNumberOfSpatialStreams()),
+    numberOfDataSubcarriers(pm.getNumberOfDataSubcarriers()),
+    preambleMode(pm.getPreambleModeId()),
+    guardInterval(pm.getGuardIntervalDuration())
+{
+    // 3 bits for the number of streams, 3 bits each for modulation and
+    // coding rate of every stream
+    for (unsigned int i = 0; i < pm.getNumberOfSpatialStreams(); ++i)
+    {
+        streams = (streams << 6) |
+            (static_cast<unsigned int>(pm.getMCS(i).getModulationId()) << 3) |
+            static_cast<unsigned int>(pm.getMCS(i).getRateId());
+    }
+}
+
+bool
+Duration::TimingKey::operator<(const TimingKey& rhs) const
+{
+    if(streams != rhs.streams)
+    {
+        return(streams < rhs.streams);
+    }
+    if(numberOfDataSubcarriers != rhs.numberOfDataSubcarriers)
+    {
+        return(numberOfDataSubcarriers < rhs.numberOfDataSubcarriers);
+    }
+    if(preambleMode != rhs.preambleMode)
+    {
+        return(preambleMode < rhs.preambleMode);
+    }
+    return(guardInterval < rhs.guardInterval);
+}
+
+bool
+Duration::TimingKey::operator==(const TimingKey& rhs) const
+{
+    return(streams == rhs.streams and
+           numberOfDataSubcarriers == rhs.numberOfDataSubcarriers and
+           preambleMode == rhs.preambleMode and
+           guardInterval == rhs.guardInterval);
+}
+
+const Duration::Timing&
+Duration::timing(const wifimac::convergence::PhyMode& pm) const
+{
+    const TimingKey key(pm);
+
+    if(lastTiming != timingCache.end() and lastTiming->first == key)
+    {
+        return(lastTiming->second);
+    }
+
+    TimingCache::const_iterator it = timingCache.find(key);
+    if(it == timingCache.end())
+    {
+        Timing t;
+        t.dataBitsPerSymbol = pm.getDataBitsPerSymbol();
+        t.symbol = this->symbolWithoutGI + pm.getGuardIntervalDuration();
+        t.preamble = computePreamble(pm);
+        it = timingCache.insert(std::make_pair(key, t)).first;
+    }
+    lastTiming = it;
+    return(it->second);
+}
+
 unsigned int
 Duration::ofdmSymbols(Bit psduLength, const wifimac::convergence::PhyMode& pm) const
 {
     unsigned int n_es = 1;
     // TODO: correct n_es for higher phy modes
-    return(static_cast<int>(ceil(static_cast<double>(psduLength + fl->service + fl->tail*n_es) /
-                                 static_cast<double>(pm.getDataBitsPerSymbol()))));
+    const Bit dbps = timing(pm).dataBitsPerSymbol;
+    assure(dbps > 0, "PhyMode has no data bits per symbol");
+
+    // ceil((psduLength + service + tail*n_es) / dbps)
+    return(static_cast<unsigned int>((psduLength + fl->service + fl->tail*n_es + dbps - 1) / dbps));
 }
 
 wns::simulator::Time
 Duration::frame(Bit psduLength, const wifimac::convergence::PhyMode& pm) const
 {
-    return(preamble(pm) + ofdmSymbols(psduLength, pm) * symbol(pm));
+    const Timing& t = timing(pm);
+    return(t.preamble + ofdmSymbols(psduLength, pm) * t.symbol);
 }
 
 wns::simulator::Time
@@ -76,13 +150,19 @@ Duration::frame(Bit psduLength, const double grossBitRate, const wifimac::conver
 
 wns::simulator::Time
 Duration::preamble(const wifimac::convergence::PhyMode& pm) const
+{
+    return(timing(pm).preamble);
+}
+
+wns::simulator::Time
+Duration::computePreamble(const wifimac::convergence::PhyMode& pm) const
 {
     // number of DLFT and ELFT in HT-preamble (D802.11n,D4.00, Table 20-11~13)
     // here: N_ss=N_sts=Mt, and N_ess=0
 
     unsigned int dltf = 0;
     unsigned int eltf = 0;
-    wns::simulator::Time s = symbol(pm);
+    wns::simulator::Time s = this->symbolWithoutGI + pm.getGuardIntervalDuration();
 
     if(pm.getNumberOfSpatialStreams() == 3)
     {
@@ -93,12 +173,12 @@ Duration::preamble(const wifimac::convergence::PhyMode& pm) const
         dltf = pm.getNumberOfSpatialStreams();
     }
 
-    if(pm.getPreambleMode() == "Basic")
+    if(pm.getPreambleModeId() == wifimac::convergence::BasicPreamble)
     {
         return(16e-6 + s);
     }
 
-    if(pm.getPreambleMode() == "HT-Mix")
+    if(pm.getPreambleModeId() == wifimac::convergence::HTMixPreamble)
     {
         // Non-HT short training sequence (D802.11n,D4.00, Table 20-5): 8 us
         // Non-HT long training sequence (D802.11n,D4.00, Table 20-5): 8 us
@@ -112,7 +192,7 @@ Duration::preamble(const wifimac::convergence::PhyMode& pm) const
         return(16e-6 + s + (2 + dltf + eltf - 1)*4e-6 + 2*s);
     }
 
-    if(pm.getPreambleMode() == "HT-GF")
+    if(pm.getPreambleModeId() == wifimac::convergence::HTGFPreamble)
     {
         // Greenfield mode
         // HT-GF short traning field duration
@@ -129,7 +209,7 @@ Duration::preamble(const wifimac::convergence::PhyMode& pm) const
         return(8e-6 + 8e-6 + (dltf + eltf - 1)*4e-6 + 2*s);
     }
 
-    assure(pm.getPreambleMode() == "Basic" or pm.getPreambleMode() == "HT-Mix" or pm.getPreambleMode() == "HT-GF", "Unknown plcpMode");
+    assure(pm.getPreambleModeId() < wifimac::convergence::numPreambleModes, "Unknown plcpMode");
 
     return(1);
 }
@@ -239,5 +319,5 @@ Duration::A_MSDU_PPDU(const std::vector<Bit>& msduFrameSize, const wifimac::conv
 wns::simulator::Time
 Duration::symbol(const wifimac::convergence::PhyMode &pm) const
 {
-    return(this->symbolWithoutGI + pm.getGuardIntervalDuration());
+    return(timing(pm).symbol);
 }
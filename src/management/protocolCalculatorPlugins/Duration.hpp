@@ -39,6 +39,8 @@
 #include <WNS/pyconfig/View.hpp>
 #include <WNS/simulator/Time.hpp>
 
+#include <map>
+
 
 namespace wifimac { namespace management {
         class ProtocolCalculator;
@@ -52,6 +54,12 @@ namespace wifimac { namespace management { namespace protocolCalculatorPlugins {
      * phy parameters like data bits per symbol, number of streams etc
      * the (A)M(S/P)DU duration functions expect the proper size(s) of the PDU(s)
      * e.g. a vector with frame sizes for an aggregated MPDU
+     *
+     * The quantities which depend on the PhyMode only (data bits per symbol,
+     * symbol and preamble duration) are computed once per PhyMode and cached,
+     * the number of OFDM symbols is derived from them with integer
+     * arithmetic. As the Duration is owned by the ProtocolCalculator, the
+     * cache is shared by all FUs of a node.
      */
     class Duration
     {
@@ -125,9 +133,55 @@ namespace wifimac { namespace management { namespace protocolCalculatorPlugins {
         const wns::simulator::Time slot;
 
     private:
+        /**
+         * @brief Identifies the PhyMode properties the durations depend on:
+         * the modulation and coding of all spatial streams, the number of
+         * data subcarriers, preamble mode and guard interval
+         */
+        struct TimingKey
+        {
+            TimingKey(const wifimac::convergence::PhyMode& pm);
+
+            bool
+            operator<(const TimingKey& rhs) const;
+
+            bool
+            operator==(const TimingKey& rhs) const;
+
+            unsigned int streams;
+            unsigned int numberOfDataSubcarriers;
+            wifimac::convergence::PreambleModeId preambleMode;
+            wns::simulator::Time guardInterval;
+        };
+
+        /**
+         * @brief Durations and sizes which depend on the PhyMode only
+         */
+        struct Timing
+        {
+            Bit dataBitsPerSymbol;
+            wns::simulator::Time symbol;
+            wns::simulator::Time preamble;
+        };
+
+        typedef std::map<TimingKey, Timing> TimingCache;
+
+        /// @brief Cached timing of the PhyMode, computed on first use
+        const Timing&
+        timing(const wifimac::convergence::PhyMode& pm) const;
+
+        /// @brief Uncached computation of the preamble duration
+        wns::simulator::Time
+        computePreamble(const wifimac::convergence::PhyMode& pm) const;
+
         const wns::simulator::Time symbolWithoutGI;
         const wifimac::management::protocolCalculatorPlugins::FrameLength* fl;
 
+        mutable TimingCache timingCache;
+
+        /// @brief Shortcut to the last used entry of the timingCache
+        mutable TimingCache::const_iterator lastTiming;
+
 
     };
 } // protocolCalculatorPlugins
@@ -32,190 +32,401 @@
 #include <WNS/simulator/Time.hpp>
 
 #include <cmath>
+#include <cfloat>
+#include <limits>
 #include <algorithm>
 
 using namespace wifimac::management::protocolCalculatorPlugins;
 
-ErrorProbability::ErrorProbability()
-{
+namespace {
+    /// @brief Largest distance of the first error event approximation
+    const int maxDistance = 22;
+
+    /// @brief Number of paths with distance d (index) of the convolutional
+    /// code, for each coding rate
+    const double distanceSpectrum[wifimac::convergence::numCodingRates][maxDistance + 1] = {
+        // 1/2
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         11, 0, 38, 0, 193, 0, 1331, 0, 7275, 0,
+         40406, 0, 234969},
+        // 2/3
+        {0, 0, 0, 0, 0, 0, 1, 16, 48, 158,
+         642, 2435, 6174, 34705, 131585, 499608, 0, 0, 0, 0,
+         0, 0, 0},
+        // 3/4
+        {0, 0, 0, 0, 0, 8, 31, 160, 892, 4512,
+         23307, 121077, 625059, 3234886, 16753077, 0, 0, 0, 0, 0,
+         0, 0, 0},
+        // 5/6
+        {0, 0, 0, 0, 14, 69, 654, 4996, 39677, 314973,
+         2503576, 19875546, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0}
+    };
+
+    /// @brief Initial distance between two table entries (amplitude)
+    const double initialResolution = 0.01;
 
+    /// @brief Smallest allowed table resolution (amplitude)
+    const double minResolution = 1e-6;
 }
 
-double
-ErrorProbability::getPER(std::vector<wns::Ratio> snr,
-                         Bit packetLength,
-                         wifimac::convergence::PhyMode phyMode) const
+ErrorProbability::ErrorProbability(const wns::pyconfig::View& config):
+    tables(getTables(config.get<double>("maxSINR"), config.get<double>("tolerance")))
 {
-    // if the packet length is unknown, one symbol is assumed
-    if(packetLength == 0)
-    {
-        packetLength = phyMode.getDataBitsPerSymbol();
-    }
 
-    double cyclicPrefixReduction = 0.0;
-    if(phyMode.getGuardIntervalDuration() == 0.8e-6)
-    {
-        cyclicPrefixReduction = 0.8;
-    }
-    if(phyMode.getGuardIntervalDuration() == 0.4e-6)
-    {
-        cyclicPrefixReduction = 0.9;
-    }
-    assure(cyclicPrefixReduction > 0, "Unknown guard interval");
+}
 
-    double bitSuccessRate = 1.0;
+ErrorProbability::ErrorProbability(const ConfigGetter& config):
+    tables(getTables(config.get<double>("maxSINR", "d"), config.get<double>("tolerance", "d")))
+{
 
-    std::vector<wifimac::convergence::MCS> v = phyMode.getSpatialStreams();
-    assure(v.size() > 0, "Must have at least one spatial stream");
-    assure(v.size() == snr.size(), "Number of spatial streams and SNRs must match");
+}
 
-    std::vector<wns::Ratio>::const_iterator itSNR = snr.begin();
-    std::vector<wifimac::convergence::MCS>::const_iterator itV = v.begin();
+boost::shared_ptr<const ErrorProbability::Tables>
+ErrorProbability::getTables(double maxSINR, double tolerance)
+{
+    static TableCache cache;
 
-    for(;
-        itSNR != snr.end(), itV != v.end();
-        ++itSNR, ++itV)
+    boost::shared_ptr<const Tables>& entry = cache[std::make_pair(maxSINR, tolerance)];
+    if(not entry)
     {
-        double snr = itSNR->get_factor() * cyclicPrefixReduction;
+        Tables* t = new Tables();
+        createTables(*t, sqrt(pow(10.0, maxSINR / 10.0)), tolerance);
+        entry.reset(t);
+    }
+    return entry;
+}
 
-        double ser = 0.0;
-        double ber = 0.0;
+void
+ErrorProbability::createTables(Tables& tables, double maxAmplitude, double tolerance)
+{
+    assure(maxAmplitude > 0.0, "maxSINR is too small");
+    assure(tolerance > 0.0, "tolerance must be positive");
 
-        if(itV->getModulation() == "BPSK")
-        {
-            ser = Q(sqrt(2*snr));
-            ber = ser;
-        }
-        else if(itV->getModulation() == "QPSK")
+    tables.resolution = initialResolution;
+    while(true)
+    {
+        tables.size = static_cast<int>(ceil(maxAmplitude / tables.resolution)) + 1;
+
+        for(int m = 0; m < wifimac::convergence::numModulations; ++m)
         {
-            ser = 2.0 * Q(sqrt(snr)) * (1.0 - 0.5 * Q(sqrt(snr)));
-            ber = 0.5 * ser;
+            const wifimac::convergence::ModulationId modulation = static_cast<wifimac::convergence::ModulationId>(m);
+            tables.logBER[m].resize(tables.size);
+            for(int i = 0; i < tables.size; ++i)
+            {
+                const double amplitude = i * tables.resolution;
+                const double ber = computeBER(modulation, amplitude * amplitude);
+                // bit error rates below the smallest normalized double are
+                // treated as zero
+                tables.logBER[m][i] = (ber < DBL_MIN) ? -std::numeric_limits<double>::infinity() : log(ber);
+            }
         }
-        else if(itV->getModulation() == "QAM16")
+
+        // the interpolation error is largest between two entries
+        double maxError = 0.0;
+        for(int m = 0; m < wifimac::convergence::numModulations; ++m)
         {
-            double P_sqrt16 = 3.0/2.0 * Q(sqrt((3.0/15.0) * snr));
-            ser = 1 - pow((1 - P_sqrt16), 2);
-            ber = ser / 4.0;
+            const wifimac::convergence::ModulationId modulation = static_cast<wifimac::convergence::ModulationId>(m);
+            for(int i = 0; i < tables.size - 1; ++i)
+            {
+                const double amplitude = (i + 0.5) * tables.resolution;
+                const double exact = computeBER(modulation, amplitude * amplitude);
+                if(exact < DBL_MIN)
+                {
+                    continue;
+                }
+                maxError = std::max(maxError, fabs(lookupBER(tables, modulation, amplitude) - exact) / exact);
+            }
         }
-        else if(itV->getModulation() == "QAM64")
+
+        if(maxError <= tolerance)
         {
-            double P_sqrt64 = 7.0/4.0 * Q(sqrt((3.0/63.0) * snr));
-            ser = 1 - pow((1 - P_sqrt64), 2);
-            ber = ser / 6.0;
+            return;
         }
 
+        tables.resolution /= 2.0;
+        assure(tables.resolution >= minResolution, "Cannot reach tolerance " << tolerance << " for the bit error rate tables");
+    }
+}
+
+double
+ErrorProbability::getPER(const std::vector<wns::Ratio>& snr,
+                         Bit packetLength,
+                         const wifimac::convergence::PhyMode& phyMode) const
+{
+    return(getPERFromCodedError(getCodedError(snr, phyMode), packetLength, phyMode));
+}
+
+double
+ErrorProbability::getPER(wns::Ratio postSNR,
+                         Bit packetLength,
+                         const wifimac::convergence::PhyMode& phyMode) const
+{
+    return(getPERFromCodedError(getCodedError(postSNR, phyMode), packetLength, phyMode));
+}
+
+void
+ErrorProbability::getPER(const std::vector<wns::Ratio>& snr,
+                         const std::vector<Bit>& packetLengths,
+                         const wifimac::convergence::PhyMode& phyMode,
+                         std::vector<double>& per) const
+{
+    getPERFromCodedError(getCodedError(snr, phyMode), packetLengths, phyMode, per);
+}
+
+void
+ErrorProbability::getPER(wns::Ratio postSNR,
+                         const std::vector<Bit>& packetLengths,
+                         const wifimac::convergence::PhyMode& phyMode,
+                         std::vector<double>& per) const
+{
+    getPERFromCodedError(getCodedError(postSNR, phyMode), packetLengths, phyMode, per);
+}
+
+double
+ErrorProbability::getCodedError(const std::vector<wns::Ratio>& snr,
+                                const wifimac::convergence::PhyMode& phyMode) const
+{
+    const unsigned int numSS = phyMode.getNumberOfSpatialStreams();
+    assure(numSS > 0, "Must have at least one spatial stream");
+    assure(numSS == snr.size(), "Number of spatial streams and SNRs must match");
+
+    const double reduction = getCyclicPrefixReduction(phyMode);
+    double bitSuccessRate = 1.0;
+
+    for(unsigned int i = 0; i < numSS; ++i)
+    {
+        const double ber = lookupBER(*tables, phyMode.getMCS(i).getModulationId(), sqrt(snr[i].get_factor() * reduction));
+
         bitSuccessRate *= (1.0 - ber);
 
         assure((bitSuccessRate >= 0.0 and bitSuccessRate <= 1.0) and
-               (ber >= 0.0 and ber <= 1.0) and
-               (ser >= 0.0 and ser <= 1.0),
+               (ber >= 0.0 and ber <= 1.0),
                "Calculated error probabilities are not valid");
     }
 
-    double ber = (1.0 - bitSuccessRate);
-    double u = 0.0;
+    return(codedErrorFromBER(1.0 - bitSuccessRate, phyMode));
+}
 
-    // only the first coding rate is taken
-    if(phyMode.getSpatialStreams()[0].getRate() ==  "1/2")
+double
+ErrorProbability::getCodedError(wns::Ratio postSNR,
+                                const wifimac::convergence::PhyMode& phyMode) const
+{
+    const unsigned int numSS = phyMode.getNumberOfSpatialStreams();
+    assure(numSS > 0, "Must have at least one spatial stream");
+
+    // all spatial streams have the same snr
+    const double amplitude = sqrt(postSNR.get_factor() * getCyclicPrefixReduction(phyMode));
+    double bitSuccessRate = 1.0;
+
+    for(unsigned int i = 0; i < numSS; ++i)
     {
-        u = std::min(1.0, Pu12(ber));
+        const double ber = lookupBER(*tables, phyMode.getMCS(i).getModulationId(), amplitude);
+
+        bitSuccessRate *= (1.0 - ber);
+
+        assure((bitSuccessRate >= 0.0 and bitSuccessRate <= 1.0) and
+               (ber >= 0.0 and ber <= 1.0),
+               "Calculated error probabilities are not valid");
     }
-    else if(phyMode.getSpatialStreams()[0].getRate() == "2/3")
+
+    return(codedErrorFromBER(1.0 - bitSuccessRate, phyMode));
+}
+
+bool
+ErrorProbability::hasSameCodedError(const wifimac::convergence::PhyMode& a,
+                                    const wifimac::convergence::PhyMode& b)
+{
+    if(a.getNumberOfSpatialStreams() != b.getNumberOfSpatialStreams() or
+       a.getGuardIntervalDuration() != b.getGuardIntervalDuration())
     {
-        u = std::min(1.0, Pu23(ber));
+        return false;
     }
-    else if(phyMode.getSpatialStreams()[0].getRate() == "3/4")
+    for(unsigned int i = 0; i < a.getNumberOfSpatialStreams(); ++i)
     {
-        u = std::min(1.0, Pu34(ber));
+        if(a.getMCS(i).getModulationId() != b.getMCS(i).getModulationId() or
+           a.getMCS(i).getRateId() != b.getMCS(i).getRateId())
+        {
+            return false;
+        }
     }
-    else if(phyMode.getSpatialStreams()[0].getRate() == "5/6")
+    return true;
+}
+
+double
+ErrorProbability::getPERFromCodedError(double codedError,
+                                       Bit packetLength,
+                                       const wifimac::convergence::PhyMode& phyMode) const
+{
+    assure(codedError >= 0.0 and codedError <= 1.0, "Coded error probability is not valid");
+
+    // if the packet length is unknown, one symbol is assumed
+    if(packetLength == 0)
     {
-        u = std::min(1.0, Pu56(ber));
+        packetLength = phyMode.getDataBitsPerSymbol();
     }
 
-    double per = 1.0 - pow(1.0 - u, static_cast<double>(packetLength));
+    // per = 1 - (1-u)^packetLength, without cancellation for small u
+    double per = 0.0;
+    if(codedError >= 1.0)
+    {
+        per = 1.0;
+    }
+    else if(codedError > 0.0)
+    {
+        per = -expm1(static_cast<double>(packetLength) * log1p(-codedError));
+    }
 
-    assure((per >= 0.0 and per <= 1.0) and
-           (u >= 0.0 and u <= 1.0),
-           "Calculated error probabilities are not valid");
+    assure(per >= 0.0 and per <= 1.0, "Calculated error probabilities are not valid");
 
     return per;
 }
 
-double
-ErrorProbability::getPER(wns::Ratio postSNR,
-                         Bit packetLength,
-                         wifimac::convergence::PhyMode phyMode) const
+void
+ErrorProbability::getPERFromCodedError(double codedError,
+                                       const std::vector<Bit>& packetLengths,
+                                       const wifimac::convergence::PhyMode& phyMode,
+                                       std::vector<double>& per) const
 {
-    std::vector<wns::Ratio> snr(phyMode.getNumberOfSpatialStreams(), postSNR);
-    return(this->getPER(snr, packetLength, phyMode));
+    assure(codedError >= 0.0 and codedError <= 1.0, "Coded error probability is not valid");
+
+    const size_t n = packetLengths.size();
+    per.resize(n);
+
+    if(codedError <= 0.0 or codedError >= 1.0)
+    {
+        std::fill(per.begin(), per.end(), (codedError >= 1.0) ? 1.0 : 0.0);
+        return;
+    }
+
+    // if the packet length is unknown, one symbol is assumed
+    const double defaultLength = static_cast<double>(phyMode.getDataBitsPerSymbol());
+    const double logSuccess = log1p(-codedError);
+
+    // all packets share log(1-u), hence the loop body is free of branches
+    // and calls except for expm1
+    const Bit* lengths = n > 0 ? &packetLengths[0] : NULL;
+    double* result = n > 0 ? &per[0] : NULL;
+    for(size_t i = 0; i < n; ++i)
+    {
+        const double length = (lengths[i] == 0) ? defaultLength : static_cast<double>(lengths[i]);
+        result[i] = -expm1(length * logSuccess);
+    }
 }
 
 double
-ErrorProbability::Pd(double p, double d) const
+ErrorProbability::codedErrorFromBER(double ber, const wifimac::convergence::PhyMode& phyMode) const
 {
-    // Chernoff - Approximation
-    return (pow(4*p*(1-p), d/2));
+    // only the first coding rate is taken
+    const double u = std::min(1.0, Pu(phyMode.getMCS(0).getRateId(), ber));
+
+    assure(u >= 0.0 and u <= 1.0, "Calculated error probabilities are not valid");
+
+    return u;
 }
 
 double
-ErrorProbability::Pu12(double rawBer) const
+ErrorProbability::getCyclicPrefixReduction(const wifimac::convergence::PhyMode& phyMode) const
 {
-    return( 11 * Pd(rawBer,10) +
-            38 * Pd(rawBer,12) +
-            193 * Pd(rawBer, 14) +
-            1331 * Pd(rawBer, 16) +
-            7275 * Pd(rawBer, 18) +
-            40406 * Pd(rawBer, 20) +
-            234969 * Pd(rawBer, 22) );
+    if(phyMode.getGuardIntervalDuration() == 0.8e-6)
+    {
+        return(0.8);
+    }
+    assure(phyMode.getGuardIntervalDuration() == 0.4e-6, "Unknown guard interval");
+    return(0.9);
 }
 
 double
-ErrorProbability::Pu23(double rawBer) const
+ErrorProbability::lookupBER(const Tables& tables, wifimac::convergence::ModulationId modulation, double amplitude)
 {
-    return( Pd(rawBer,6) +
-            16 * Pd(rawBer, 7) +
-            48 * Pd(rawBer, 8) +
-            158 * Pd(rawBer, 9) +
-            642 * Pd(rawBer, 10) +
-            2435 * Pd(rawBer, 11) +
-            6174 * Pd(rawBer, 12) +
-            34705 * Pd(rawBer, 13) +
-            131585 * Pd(rawBer, 14) +
-            499608 * Pd(rawBer, 15));
+    assure(modulation < wifimac::convergence::numModulations, "Unknown modulation");
+
+    const std::vector<double>& table = tables.logBER[modulation];
+    const double x = amplitude / tables.resolution;
+
+    if(x < tables.size - 1)
+    {
+        const int i = static_cast<int>(x);
+        if(table[i + 1] != -std::numeric_limits<double>::infinity())
+        {
+            return(exp(table[i] + (x - i) * (table[i + 1] - table[i])));
+        }
+        if(table[i] == -std::numeric_limits<double>::infinity())
+        {
+            return(0.0);
+        }
+    }
+    else if(table[tables.size - 1] == -std::numeric_limits<double>::infinity())
+    {
+        // the bit error rate is decreasing with the snr
+        return(0.0);
+    }
+
+    return(computeBER(modulation, amplitude * amplitude));
 }
 
 double
-ErrorProbability::Pu34(double rawBer) const
+ErrorProbability::computeBER(wifimac::convergence::ModulationId modulation, double snr)
 {
-    return( 8 * Pd(rawBer, 5) +
-            31 * Pd(rawBer, 6) +
-            160 * Pd(rawBer, 7) +
-            892 * Pd(rawBer, 8) +
-            4512 * Pd(rawBer, 9) +
-            23307 * Pd(rawBer, 10) +
-            121077 * Pd(rawBer, 11) +
-            625059 * Pd(rawBer, 12) +
-            3234886 * Pd(rawBer, 13) +
-            16753077 * Pd(rawBer, 14));
+    double ser = 0.0;
+    double ber = 0.0;
+
+    switch(modulation)
+    {
+    case wifimac::convergence::BPSK:
+        ser = Q(sqrt(2*snr));
+        ber = ser;
+        break;
+    case wifimac::convergence::QPSK:
+        ser = 2.0 * Q(sqrt(snr)) * (1.0 - 0.5 * Q(sqrt(snr)));
+        ber = 0.5 * ser;
+        break;
+    case wifimac::convergence::QAM16:
+    {
+        // 1 - (1-P)^2, without cancellation for small P
+        double P_sqrt16 = 3.0/2.0 * Q(sqrt((3.0/15.0) * snr));
+        ser = P_sqrt16 * (2.0 - P_sqrt16);
+        ber = ser / 4.0;
+        break;
+    }
+    case wifimac::convergence::QAM64:
+    {
+        double P_sqrt64 = 7.0/4.0 * Q(sqrt((3.0/63.0) * snr));
+        ser = P_sqrt64 * (2.0 - P_sqrt64);
+        ber = ser / 6.0;
+        break;
+    }
+    default:
+        assure(false, "Unknown modulation");
+    }
+
+    assure((ber >= 0.0 and ber <= 1.0) and
+           (ser >= 0.0 and ser <= 1.0),
+           "Calculated error probabilities are not valid");
+
+    return ber;
 }
 
 double
-ErrorProbability::Pu56(double rawBer) const
+ErrorProbability::Pu(wifimac::convergence::CodingRateId rate, double rawBer) const
 {
-    return( 14 * Pd(rawBer, 4) +
-            69 * Pd(rawBer, 5) +
-            654 * Pd(rawBer, 6) +
-            4996 * Pd(rawBer, 7) +
-            39677 * Pd(rawBer, 8) +
-            314973 * Pd(rawBer, 9) +
-            2503576 * Pd(rawBer, 10) +
-            19875546 * Pd(rawBer, 11));
+    assure(rate < wifimac::convergence::numCodingRates, "Unknown coding rate");
+
+    // Chernoff - Approximation: the pairwise error probability of two paths
+    // that differ in d bits is z^d with z = sqrt(4p(1-p))
+    const double z = sqrt(4 * rawBer * (1 - rawBer));
+    const double* spectrum = distanceSpectrum[rate];
+
+    double u = 0.0;
+    for(int d = maxDistance; d >= 0; --d)
+    {
+        u = u * z + spectrum[d];
+    }
+    return(u);
 }
 
 double
-ErrorProbability::Q(double x) const
+ErrorProbability::Q(double x)
 {
     return( erfc(x/sqrt(2.0)) /  2.0);
 }
-
@@ -30,47 +30,158 @@
 #define WIFIMAC_MANAGEMENT_PROTOCOLCALCULATORPLUGINS_ERRORPROBABILITY_HPP
 
 #include <WIFIMAC/convergence/PhyMode.hpp>
+#include <WIFIMAC/management/protocolCalculatorPlugins/ConfigGetter.hpp>
 
 #include <WNS/pyconfig/View.hpp>
 #include <WNS/PowerRatio.hpp>
 
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+#include <map>
+
 namespace wifimac { namespace management { namespace protocolCalculatorPlugins {
 
     /**
      * @brief This class calculates the packet|bit|symbol error probability for
      * a given SNR, packet length and wifimac::convergence::PhyMode.
+     *
+     * The uncoded bit error rate of each modulation is precomputed at
+     * construction for SNRs (after the cyclic prefix reduction) up to
+     * maxSINR. The tables are indexed by the amplitude sqrt(snr), for which
+     * the logarithm of the bit error rate is smooth with bounded curvature,
+     * and linearly interpolated in the logarithmic domain. The table
+     * resolution is refined until the interpolated bit error rates deviate by
+     * at most the configured relative tolerance from the exact values. SNRs
+     * beyond the table range are computed exactly. The tables are shared by
+     * all instances with the same configuration.
+     *
+     * The first error event probability of the convolutional code is a
+     * polynomial in sqrt(4p(1-p)) which is evaluated with the Horner scheme.
+     *
+     * The computation is split into the coded error probability u, which
+     * depends on the SNR and the phyMode only, and the packet error rate
+     * 1-(1-u)^length. Hence, packets with the same SNR and phyMode (e.g. the
+     * subframes of an A-MPDU) share u, either by the batch getPER for a set of
+     * lengths, or by getCodedError() and getPERFromCodedError().
      */
     class ErrorProbability
     {
     public:
-        ErrorProbability();
+        ErrorProbability(const wns::pyconfig::View& config);
+
+        ErrorProbability(const ConfigGetter& config);
+
+        double
+        getPER(const std::vector<wns::Ratio>& snr, Bit packetLength, const wifimac::convergence::PhyMode& phyMode) const;
+
+        double
+        getPER(wns::Ratio postSNR, Bit packetLength, const wifimac::convergence::PhyMode& phyMode) const;
+
+        /**
+         * @brief Packet error rates of packets with the given lengths which are
+         * received with the same snr and phyMode
+         */
+        void
+        getPER(const std::vector<wns::Ratio>& snr,
+               const std::vector<Bit>& packetLengths,
+               const wifimac::convergence::PhyMode& phyMode,
+               std::vector<double>& per) const;
+
+        void
+        getPER(wns::Ratio postSNR,
+               const std::vector<Bit>& packetLengths,
+               const wifimac::convergence::PhyMode& phyMode,
+               std::vector<double>& per) const;
+
+        /**
+         * @brief Probability of a bit error after decoding, independent of the
+         * packet length
+         */
+        double
+        getCodedError(const std::vector<wns::Ratio>& snr, const wifimac::convergence::PhyMode& phyMode) const;
 
         double
-        getPER(std::vector<wns::Ratio> snr, Bit packetLength, wifimac::convergence::PhyMode phyMode) const;
+        getCodedError(wns::Ratio postSNR, const wifimac::convergence::PhyMode& phyMode) const;
 
+        /**
+         * @brief True if getCodedError() depends on the same parameters of
+         * both phyModes, i.e. their number of spatial streams, the modulation
+         * and coding rate of each stream and the guard interval
+         *
+         * PhyMode::operator== compares the MCSs by their minimum SINR and
+         * code rate only and ignores the guard interval.
+         */
+        static bool
+        hasSameCodedError(const wifimac::convergence::PhyMode& a, const wifimac::convergence::PhyMode& b);
+
+        /**
+         * @brief Packet error rate for the coded error probability as returned
+         * by getCodedError()
+         */
         double
-        getPER(wns::Ratio postSNR, Bit packetLength, wifimac::convergence::PhyMode phyMode) const;
+        getPERFromCodedError(double codedError, Bit packetLength, const wifimac::convergence::PhyMode& phyMode) const;
+
+        void
+        getPERFromCodedError(double codedError,
+                             const std::vector<Bit>& packetLengths,
+                             const wifimac::convergence::PhyMode& phyMode,
+                             std::vector<double>& per) const;
 
     private:
-        /// @brief Calculate probability of error in pairwise comparison of two
-        /// paths that differ in d bits
-        double Pd(double rawBer, double d) const;
+        /// @brief Logarithm of the bit error rate of each modulation
+        struct Tables
+        {
+            /// @brief Distance between two table entries (amplitude)
+            double resolution;
+
+            /// @brief Number of entries per modulation
+            int size;
+
+            std::vector<double> logBER[wifimac::convergence::numModulations];
+        };
+
+        typedef std::map<std::pair<double, double>, boost::shared_ptr<const Tables> > TableCache;
+
+        /// @brief Shared tables for the given maxSINR and tolerance, created
+        /// on first use
+        static boost::shared_ptr<const Tables>
+        getTables(double maxSINR, double tolerance);
 
-        /// @brief Calculate first error event probability of coding rate 1/2
-        double Pu12(double rawBer) const;
+        /// @brief Build tables up to maxAmplitude, refining the resolution
+        /// until the tolerance is met
+        static void
+        createTables(Tables& tables, double maxAmplitude, double tolerance);
 
-        /// @brief Calculate first error event probability of coding rate 2/3
-        double Pu23(double rawBer) const;
+        /// @brief Interpolated bit error rate of the modulation at the
+        /// amplitude sqrt(snr), exact computation if it is not covered by the
+        /// tables
+        static double
+        lookupBER(const Tables& tables, wifimac::convergence::ModulationId modulation, double amplitude);
 
-        /// @brief Calculate first error event probability of coding rate 3/4
-        double Pu34(double rawBer) const;
+        /// @brief Exact uncoded bit error rate of the modulation at the given
+        /// snr (factor)
+        static double
+        computeBER(wifimac::convergence::ModulationId modulation, double snr);
 
-        /// @brief Calculate first error event probability of coding rate 5/6
-        double Pu56(double rawBer) const;
+        /// @brief SNR reduction factor by the cyclic prefix of the phyMode
+        double
+        getCyclicPrefixReduction(const wifimac::convergence::PhyMode& phyMode) const;
+
+        /// @brief Coded error probability for the combined uncoded bit error
+        /// rate of all spatial streams
+        double
+        codedErrorFromBER(double ber, const wifimac::convergence::PhyMode& phyMode) const;
+
+        /// @brief Calculate first error event probability of the coding rate
+        double
+        Pu(wifimac::convergence::CodingRateId rate, double rawBer) const;
 
         /// @brief Computes the Q function as found in Proakis (3rd ed, 1995, eq. 2-1-98)
-        double Q(double x) const;
+        static double
+        Q(double x);
 
+        boost::shared_ptr<const Tables> tables;
     };
 } // protocolCalculatorPlugins
 } // management
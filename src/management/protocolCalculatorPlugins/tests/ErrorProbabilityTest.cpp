@@ -0,0 +1,192 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/management/protocolCalculatorPlugins/tests/ErrorProbabilityTest.hpp>
+
+#include <WNS/pyconfig/Parser.hpp>
+
+using namespace wifimac::management::protocolCalculatorPlugins::tests;
+using wifimac::management::protocolCalculatorPlugins::ErrorProbability;
+using wifimac::convergence::PhyMode;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ErrorProbabilityTest );
+
+ErrorProbabilityTest::ErrorProbabilityTest():
+    wns::TestFixture(),
+    errorProbability(NULL),
+    basicPhyMode(),
+    mimoPhyMode(),
+    lengths()
+{
+}
+
+void ErrorProbabilityTest::prepare()
+{
+    assure(this->errorProbability == NULL, "not properly deleted");
+
+    wns::pyconfig::Parser parser;
+    parser.loadString("from openwns import dB\n"
+                      "import wifimac.convergence.PhyMode\n"
+                      "import wifimac.protocolCalculator.ErrorProbability\n"
+                      "\n"
+                      "errorProbability = wifimac.protocolCalculator.ErrorProbability.ErrorProbability()\n"
+                      "basicPhyMode = wifimac.convergence.PhyMode.makeBasicPhyMode(\"QAM16\", \"3/4\", dB(18.8))\n"
+                      "mimoPhyMode = wifimac.convergence.PhyMode.makeBasicPhyMode(\"QAM64\", \"2/3\", dB(23.5))\n"
+                      "mimoPhyMode.spatialStreams.append(wifimac.convergence.PhyMode.MCS(\"QPSK\", \"1/2\", dB(8.8)))\n"
+                      "mimoPhyMode.guardIntervalDuration = 0.4e-6\n");
+
+    this->errorProbability = new ErrorProbability(parser.get("errorProbability"));
+    this->basicPhyMode = PhyMode(parser.get("basicPhyMode"));
+    this->mimoPhyMode = PhyMode(parser.get("mimoPhyMode"));
+
+    // the subframes of an A-MPDU, from a single symbol up to the maximum
+    // MPDU size
+    this->lengths.clear();
+    this->lengths.push_back(0);
+    this->lengths.push_back(1);
+    this->lengths.push_back(8 * 40);
+    this->lengths.push_back(8 * 1500);
+    this->lengths.push_back(8 * 1500);
+    this->lengths.push_back(8 * 4095);
+}
+
+void ErrorProbabilityTest::cleanup()
+{
+    assure(this->errorProbability != NULL, "not properly created");
+    delete this->errorProbability;
+    this->errorProbability = NULL;
+}
+
+void ErrorProbabilityTest::assertEqualPER(const std::vector<double>& per,
+                                          const std::vector<double>& expected) const
+{
+    CPPUNIT_ASSERT_EQUAL(expected.size(), per.size());
+    for(size_t i = 0; i < expected.size(); ++i)
+    {
+        CPPUNIT_ASSERT(per[i] >= 0.0 and per[i] <= 1.0);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], per[i], 1e-12 * expected[i]);
+    }
+}
+
+void ErrorProbabilityTest::batchEqualsScalar()
+{
+    const PhyMode phyModes[] = {basicPhyMode, mimoPhyMode};
+
+    // from certain loss up to SNRs beyond the range of the tables
+    for(int pm = 0; pm < 2; ++pm)
+    {
+        for(double sinr = -5.0; sinr <= 50.0; sinr += 0.5)
+        {
+            const wns::Ratio postSNR = wns::Ratio::from_dB(sinr);
+
+            std::vector<double> expected;
+            for(size_t i = 0; i < lengths.size(); ++i)
+            {
+                expected.push_back(errorProbability->getPER(postSNR, lengths[i], phyModes[pm]));
+            }
+
+            // the result vector is resized, whatever its previous size
+            std::vector<double> per(2 * lengths.size(), -1.0);
+            errorProbability->getPER(postSNR, lengths, phyModes[pm], per);
+            assertEqualPER(per, expected);
+
+            // the same via the coded error
+            const double codedError = errorProbability->getCodedError(postSNR, phyModes[pm]);
+            errorProbability->getPERFromCodedError(codedError, lengths, phyModes[pm], per);
+            assertEqualPER(per, expected);
+        }
+    }
+}
+
+void ErrorProbabilityTest::batchEqualsScalarPerStream()
+{
+    for(double sinr = -5.0; sinr <= 50.0; sinr += 0.5)
+    {
+        // the second stream is received 3dB worse than the first
+        std::vector<wns::Ratio> snr;
+        snr.push_back(wns::Ratio::from_dB(sinr));
+        snr.push_back(wns::Ratio::from_dB(sinr - 3.0));
+
+        std::vector<double> expected;
+        for(size_t i = 0; i < lengths.size(); ++i)
+        {
+            expected.push_back(errorProbability->getPER(snr, lengths[i], mimoPhyMode));
+        }
+
+        std::vector<double> per;
+        errorProbability->getPER(snr, lengths, mimoPhyMode, per);
+        assertEqualPER(per, expected);
+    }
+}
+
+void ErrorProbabilityTest::emptyBatch()
+{
+    std::vector<double> per(3, -1.0);
+    errorProbability->getPER(wns::Ratio::from_dB(10.0), std::vector<Bit>(), basicPhyMode, per);
+    CPPUNIT_ASSERT(per.empty());
+
+    // also for the shortcuts of error-free and lost packets
+    per.resize(3);
+    errorProbability->getPERFromCodedError(0.0, std::vector<Bit>(), basicPhyMode, per);
+    CPPUNIT_ASSERT(per.empty());
+    per.resize(3);
+    errorProbability->getPERFromCodedError(1.0, std::vector<Bit>(), basicPhyMode, per);
+    CPPUNIT_ASSERT(per.empty());
+}
+
+void ErrorProbabilityTest::sameCodedError()
+{
+    CPPUNIT_ASSERT(ErrorProbability::hasSameCodedError(basicPhyMode, basicPhyMode));
+    CPPUNIT_ASSERT(ErrorProbability::hasSameCodedError(mimoPhyMode, mimoPhyMode));
+    CPPUNIT_ASSERT(not ErrorProbability::hasSameCodedError(basicPhyMode, mimoPhyMode));
+
+    // the guard interval changes the cyclic prefix reduction
+    PhyMode pm = basicPhyMode;
+    pm.setGuardIntervalDuration(0.4e-6);
+    CPPUNIT_ASSERT(not ErrorProbability::hasSameCodedError(basicPhyMode, pm));
+
+    // only the first stream of mimoPhyMode
+    pm = mimoPhyMode;
+    pm.setSpatialStreams(std::vector<wifimac::convergence::MCS>(1, mimoPhyMode.getMCS(0)));
+    CPPUNIT_ASSERT(not ErrorProbability::hasSameCodedError(mimoPhyMode, pm));
+
+    // the same streams in the other order
+    std::vector<wifimac::convergence::MCS> streams;
+    streams.push_back(mimoPhyMode.getMCS(1));
+    streams.push_back(mimoPhyMode.getMCS(0));
+    pm.setSpatialStreams(streams);
+    CPPUNIT_ASSERT(not ErrorProbability::hasSameCodedError(mimoPhyMode, pm));
+
+    // the number of data subcarriers and the preamble do not matter
+    pm = basicPhyMode;
+    pm.setNumberOfDataSubcarriers(52);
+    pm.setPreambleModeId(wifimac::convergence::HTMixPreamble);
+    CPPUNIT_ASSERT(ErrorProbability::hasSameCodedError(basicPhyMode, pm));
+    CPPUNIT_ASSERT_EQUAL(errorProbability->getCodedError(wns::Ratio::from_dB(15.0), basicPhyMode),
+                         errorProbability->getCodedError(wns::Ratio::from_dB(15.0), pm));
+}
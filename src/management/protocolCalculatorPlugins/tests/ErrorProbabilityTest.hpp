@@ -0,0 +1,88 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_MANAGEMENT_PROTOCOLCALCULATORPLUGINS_TESTS_ERRORPROBABILITYTEST_HPP
+#define WIFIMAC_MANAGEMENT_PROTOCOLCALCULATORPLUGINS_TESTS_ERRORPROBABILITYTEST_HPP
+
+#include <WIFIMAC/management/protocolCalculatorPlugins/ErrorProbability.hpp>
+#include <WIFIMAC/convergence/PhyMode.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+#include <vector>
+
+namespace wifimac { namespace management { namespace protocolCalculatorPlugins { namespace tests {
+
+    class ErrorProbabilityTest:
+        public wns::TestFixture
+    {
+        CPPUNIT_TEST_SUITE( ErrorProbabilityTest );
+        CPPUNIT_TEST( batchEqualsScalar );
+        CPPUNIT_TEST( batchEqualsScalarPerStream );
+        CPPUNIT_TEST( emptyBatch );
+        CPPUNIT_TEST( sameCodedError );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        ErrorProbabilityTest();
+
+    private:
+        virtual void prepare();
+        virtual void cleanup();
+
+        // the tests
+        void batchEqualsScalar();
+        void batchEqualsScalarPerStream();
+        void emptyBatch();
+        void sameCodedError();
+
+        /**
+         * @brief Checks that each batch result equals the scalar PER of the
+         * same length
+         */
+        void
+        assertEqualPER(const std::vector<double>& per,
+                       const std::vector<double>& expected) const;
+
+        ErrorProbability* errorProbability;
+
+        /// @brief One spatial stream, long guard interval
+        wifimac::convergence::PhyMode basicPhyMode;
+        /// @brief Two spatial streams of different MCSs, short guard interval
+        wifimac::convergence::PhyMode mimoPhyMode;
+
+        /// @brief Packet lengths of the batches, 0 stands for one symbol
+        std::vector<Bit> lengths;
+    };
+
+} // tests
+} // protocolCalculatorPlugins
+} // management
+} // wifimac
+
+#endif // WIFIMAC_MANAGEMENT_PROTOCOLCALCULATORPLUGINS_TESTS_ERRORPROBABILITYTEST_HPP
@@ -0,0 +1,686 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/pathselection/AllPairsShortestPath.hpp>
+
+#include <WNS/Exception.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <string>
+
+using namespace wifimac::pathselection;
+
+/**
+ * @brief Fixed number of threads which compute the rows of the
+ * Floyd-Warshall together with the calling thread
+ *
+ * The numWorkers-1 threads sleep until run() hands out a new set of
+ * matrices. Each thread, including the caller, computes the rows
+ * first, first+numWorkers, ... and run() returns when all are done.
+ *
+ * computeRows does not allocate or check anything before the last
+ * barrier, so an exception can only occur after all threads have passed
+ * it. It is caught in the thread and rethrown by run() once the others
+ * have finished, so no thread is left waiting at the barrier.
+ */
+class AllPairsShortestPath::Workers
+{
+public:
+    Workers(const AllPairsShortestPath* _engine, int _numWorkers);
+
+    ~Workers();
+
+    int
+    size() const
+        { return numWorkers; }
+
+    void
+    run(std::vector<double>& costs, std::vector<int>& pred, std::vector<int>& next);
+
+private:
+    void
+    loop(int first);
+
+    void
+    computeRows(int first);
+
+    void
+    stop();
+
+    const AllPairsShortestPath* engine;
+    const int numWorkers;
+
+    boost::barrier barrier;
+    boost::mutex mutex;
+    boost::condition_variable jobAvailable;
+    boost::condition_variable jobDone;
+
+    /**
+     * @brief Incremented for every job, the threads compare it with the
+     * last job they have computed
+     */
+    unsigned int generation;
+    int numBusy;
+    bool shutdown;
+
+    std::vector<double>* costs;
+    std::vector<int>* pred;
+    std::vector<int>* next;
+
+    bool failed;
+    std::string error;
+
+    boost::thread_group threads;
+};
+
+AllPairsShortestPath::Workers::Workers(const AllPairsShortestPath* _engine, int _numWorkers):
+    engine(_engine),
+    numWorkers(_numWorkers),
+    barrier(_numWorkers),
+    generation(0),
+    numBusy(0),
+    shutdown(false),
+    costs(NULL),
+    pred(NULL),
+    next(NULL),
+    failed(false),
+    error()
+{
+    try
+    {
+        for (int t = 1; t < numWorkers; ++t)
+        {
+            threads.create_thread(boost::bind(&Workers::loop, this, t));
+        }
+    }
+    catch(...)
+    {
+        stop();
+        throw;
+    }
+}
+
+AllPairsShortestPath::Workers::~Workers()
+{
+    stop();
+}
+
+void
+AllPairsShortestPath::Workers::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        shutdown = true;
+    }
+    jobAvailable.notify_all();
+    threads.join_all();
+}
+
+void
+AllPairsShortestPath::Workers::run(std::vector<double>& _costs, std::vector<int>& _pred, std::vector<int>& _next)
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        costs = &_costs;
+        pred = &_pred;
+        next = &_next;
+        failed = false;
+        error.clear();
+        numBusy = numWorkers - 1;
+        ++generation;
+    }
+    jobAvailable.notify_all();
+
+    computeRows(0);
+
+    boost::mutex::scoped_lock lock(mutex);
+    while(numBusy > 0)
+    {
+        jobDone.wait(lock);
+    }
+    if(failed)
+    {
+        throw wns::Exception(error);
+    }
+}
+
+void
+AllPairsShortestPath::Workers::loop(int first)
+{
+    unsigned int computed = 0;
+    while(true)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            while(generation == computed and not shutdown)
+            {
+                jobAvailable.wait(lock);
+            }
+            if(shutdown)
+            {
+                return;
+            }
+            computed = generation;
+        }
+
+        computeRows(first);
+
+        boost::mutex::scoped_lock lock(mutex);
+        if(--numBusy == 0)
+        {
+            jobDone.notify_one();
+        }
+    }
+}
+
+void
+AllPairsShortestPath::Workers::computeRows(int first)
+{
+    try
+    {
+        engine->computeRows(*costs, *pred, *next, first, numWorkers, &barrier);
+    }
+    catch(const std::exception& e)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if(not failed)
+        {
+            failed = true;
+            error = e.what();
+        }
+    }
+    catch(...)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if(not failed)
+        {
+            failed = true;
+            error = "Unknown exception in the path computation";
+        }
+    }
+}
+
+AllPairsShortestPath::AllPairsShortestPath(int _numNodes, int _numThreads):
+    numNodes(_numNodes),
+    numThreads(_numThreads),
+    nodes(),
+    positions(_numNodes, -1),
+    pendingLinks(),
+    linkCosts(static_cast<size_t>(_numNodes) * _numNodes, inf()),
+    weights(static_cast<size_t>(_numNodes) * _numNodes, inf()),
+    pathCosts(static_cast<size_t>(_numNodes) * _numNodes, inf()),
+    nextHops(static_cast<size_t>(_numNodes) * _numNodes, 0),
+    changedDestinations(_numNodes, 0),
+    workers(NULL)
+{
+    assure(numNodes > 0, "numNodes is below or equal to zero");
+    assure(numThreads > 0, "numThreads is below or equal to zero");
+}
+
+AllPairsShortestPath::~AllPairsShortestPath()
+{
+    delete workers;
+}
+
+void
+AllPairsShortestPath::addNode(int id)
+{
+    assure(id >= 0 and id < numNodes, "id " << id << " is out of range");
+    assure(positions[id] == -1, "id " << id << " is already known");
+
+    const int pos = nodes.size();
+    nodes.push_back(id);
+    positions[id] = pos;
+
+    linkCosts[at(pos, pos)] = 0.0;
+    weights[at(pos, pos)] = 0.0;
+    pathCosts[at(pos, pos)] = 0.0;
+    nextHops[at(pos, pos)] = pos;
+    changedDestinations[pos] = 1;
+}
+
+void
+AllPairsShortestPath::setLinkCost(int from, int to, const Metric& cost)
+{
+    const int u = position(from);
+    const int v = position(to);
+
+    linkCosts[at(u, v)] = cost.isInf() ? inf() : cost.toDouble();
+    pendingLinks.push_back(std::make_pair(u, v));
+}
+
+double
+AllPairsShortestPath::effectiveWeight(int from, int to) const
+{
+    if(from != to and linkCosts[at(to, from)] == inf())
+    {
+        // only bidirectional links can be used
+        return inf();
+    }
+    return linkCosts[at(from, to)];
+}
+
+void
+AllPairsShortestPath::update()
+{
+    if(pendingLinks.size() > nodes.size())
+    {
+        recompute();
+        return;
+    }
+
+    for (std::vector<std::pair<int, int> >::const_iterator itr = pendingLinks.begin(); itr != pendingLinks.end(); ++itr)
+    {
+        applyLinkChange(itr->first, itr->second);
+    }
+    pendingLinks.clear();
+}
+
+void
+AllPairsShortestPath::applyLinkChange(int from, int to)
+{
+    // both directions are processed one after another so that the matrices
+    // are consistent with the weights after each step
+    changeWeight(from, to, effectiveWeight(from, to));
+    changeWeight(to, from, effectiveWeight(to, from));
+}
+
+void
+AllPairsShortestPath::changeWeight(int from, int to, double weight)
+{
+    const double old = weights[at(from, to)];
+
+    if(old == weight)
+    {
+        return;
+    }
+
+    weights[at(from, to)] = weight;
+
+    if(weight < old)
+    {
+        onWeightDecrease(from, to);
+    }
+    else
+    {
+        onWeightIncrease(from, to);
+    }
+}
+
+void
+AllPairsShortestPath::onWeightDecrease(int u, int v)
+{
+    const int n = nodes.size();
+    const double w = weights[at(u, v)];
+    const double* rowV = &pathCosts[at(v, 0)];
+
+    // every path which becomes shorter uses the link u->v exactly once,
+    // hence it is the concatenation of the (unchanged) paths i->u and v->j
+    for (int i = 0; i < n; ++i)
+    {
+        const double toU = pathCosts[at(i, u)];
+        if(toU == inf() or i == v)
+        {
+            // the path v->u->v->j is never shorter than v->j
+            continue;
+        }
+        const double toLink = toU + w;
+        const int firstHop = (i == u) ? v : nextHops[at(i, u)];
+
+        double* rowI = &pathCosts[at(i, 0)];
+        int* nextI = &nextHops[at(i, 0)];
+        char* changed = &changedDestinations[0];
+        for (int j = 0; j < n; ++j)
+        {
+            const double candidate = toLink + rowV[j];
+            const bool shorter = candidate < rowI[j];
+            rowI[j] = shorter ? candidate : rowI[j];
+            nextI[j] = shorter ? firstHop : nextI[j];
+            changed[j] |= shorter;
+        }
+    }
+}
+
+void
+AllPairsShortestPath::onWeightIncrease(int u, int v)
+{
+    const int n = nodes.size();
+    std::vector<NodeState> state(n);
+    std::vector<int> affectedNodes;
+    std::vector<bool> done(n);
+
+    for (int j = 0; j < n; ++j)
+    {
+        if(j == u or pathCosts[at(u, j)] == inf() or nextHops[at(u, j)] != v)
+        {
+            // the path u->j does not use the link u->v, hence no other path
+            // to j uses it
+            continue;
+        }
+
+        // find all sources whose path to j passes u, following the next hops
+        std::fill(state.begin(), state.end(), unknown);
+        state[u] = affected;
+        state[j] = unaffected;
+        affectedNodes.clear();
+
+        for (int i = 0; i < n; ++i)
+        {
+            if(state[i] != unknown)
+            {
+                continue;
+            }
+            if(pathCosts[at(i, j)] == inf())
+            {
+                // no path at all, cannot become worse
+                state[i] = unaffected;
+                continue;
+            }
+            int hop = i;
+            int numHops = 0;
+            while(state[hop] == unknown)
+            {
+                hop = nextHops[at(hop, j)];
+                assure(++numHops <= n, "Loop in next hop matrix");
+            }
+            const NodeState result = state[hop];
+            for (hop = i; state[hop] == unknown; hop = nextHops[at(hop, j)])
+            {
+                state[hop] = result;
+            }
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            if(state[i] == affected)
+            {
+                affectedNodes.push_back(i);
+                done[i] = false;
+            }
+        }
+        changedDestinations[j] = 1;
+
+        // initial estimate for the affected sources: best path over an
+        // unaffected neighbour, whose path cost to j is still valid
+        for (std::vector<int>::const_iterator i = affectedNodes.begin(); i != affectedNodes.end(); ++i)
+        {
+            double& cost = pathCosts[at(*i, j)];
+            cost = inf();
+            for (int x = 0; x < n; ++x)
+            {
+                if(x == *i or state[x] == affected)
+                {
+                    continue;
+                }
+                const double candidate = weights[at(*i, x)] + pathCosts[at(x, j)];
+                if(candidate < cost)
+                {
+                    cost = candidate;
+                    nextHops[at(*i, j)] = x;
+                }
+            }
+        }
+
+        // Dijkstra over the affected sources
+        for (size_t round = 0; round < affectedNodes.size(); ++round)
+        {
+            int best = -1;
+            double bestCost = inf();
+            for (std::vector<int>::const_iterator i = affectedNodes.begin(); i != affectedNodes.end(); ++i)
+            {
+                if(not done[*i] and pathCosts[at(*i, j)] < bestCost)
+                {
+                    best = *i;
+                    bestCost = pathCosts[at(*i, j)];
+                }
+            }
+            if(best == -1)
+            {
+                // remaining sources cannot reach j anymore
+                break;
+            }
+            done[best] = true;
+
+            for (std::vector<int>::const_iterator i = affectedNodes.begin(); i != affectedNodes.end(); ++i)
+            {
+                if(done[*i])
+                {
+                    continue;
+                }
+                const double candidate = weights[at(*i, best)] + bestCost;
+                if(candidate < pathCosts[at(*i, j)])
+                {
+                    pathCosts[at(*i, j)] = candidate;
+                    nextHops[at(*i, j)] = best;
+                }
+            }
+        }
+    }
+}
+
+void
+AllPairsShortestPath::recompute()
+{
+    pendingLinks.clear();
+
+    const int n = nodes.size();
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            weights[at(i, j)] = effectiveWeight(i, j);
+        }
+    }
+
+    std::vector<double> costs;
+    std::vector<int> next;
+    floydWarshall(costs, next);
+    replacePaths(costs, next);
+}
+
+bool
+AllPairsShortestPath::verify(double tolerance)
+{
+    std::vector<double> costs;
+    std::vector<int> next;
+    floydWarshall(costs, next);
+
+    const int n = nodes.size();
+    bool match = true;
+    for (int i = 0; i < n and match; ++i)
+    {
+        for (int j = 0; j < n and match; ++j)
+        {
+            const double full = costs[at(i, j)];
+            const double current = pathCosts[at(i, j)];
+            if(full == inf() or current == inf())
+            {
+                match = (full == current);
+            }
+            else
+            {
+                match = std::fabs(full - current) <= tolerance * full;
+            }
+        }
+    }
+
+    if(not match)
+    {
+        replacePaths(costs, next);
+    }
+    return match;
+}
+
+void
+AllPairsShortestPath::replacePaths(std::vector<double>& costs, std::vector<int>& next)
+{
+    const int n = nodes.size();
+    for (int i = 0; i < n; ++i)
+    {
+        const double* oldCosts = &pathCosts[at(i, 0)];
+        const int* oldNext = &nextHops[at(i, 0)];
+        const double* newCosts = &costs[at(i, 0)];
+        const int* newNext = &next[at(i, 0)];
+        char* changed = &changedDestinations[0];
+        for (int j = 0; j < n; ++j)
+        {
+            changed[j] |= (oldCosts[j] != newCosts[j]) or (oldNext[j] != newNext[j]);
+        }
+    }
+    pathCosts.swap(costs);
+    nextHops.swap(next);
+}
+
+void
+AllPairsShortestPath::floydWarshall(std::vector<double>& costs, std::vector<int>& next)
+{
+    const int n = nodes.size();
+    std::vector<int> pred(weights.size(), -1);
+
+    // initialize predecessor and pathCost matrix:
+    //   * predecessor: If direct link exists, predecessor is source itself
+    //   * pathCost: the effective weight
+    costs = weights;
+    next.assign(weights.size(), 0);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            if(i != j and weights[at(i, j)] != inf())
+            {
+                pred[at(i, j)] = i;
+            }
+        }
+    }
+
+    const int numWorkers = std::max(1, std::min(numThreads, n / minRowsPerThread));
+    if(numWorkers == 1)
+    {
+        computeRows(costs, pred, next, 0, 1, NULL);
+        return;
+    }
+
+    // the number of workers only changes while nodes are added
+    if(workers == NULL or workers->size() != numWorkers)
+    {
+        delete workers;
+        workers = NULL;
+        workers = new Workers(this, numWorkers);
+    }
+    workers->run(costs, pred, next);
+}
+
+void
+AllPairsShortestPath::computeRows(std::vector<double>& costs,
+                                  std::vector<int>& pred,
+                                  std::vector<int>& next,
+                                  int first,
+                                  int step,
+                                  boost::barrier* barrier) const
+{
+    const int n = nodes.size();
+
+    // Floyd-Warshall Algorithm to compute all-pairs shortest-path inclusive
+    // predecessor matrix in O(nodes^3). For a fixed k, row k and column k do
+    // not change, hence the rows can be relaxed independently against row k.
+    for (int k = 0; k < n; ++k)
+    {
+        const double* rowK = &costs[at(k, 0)];
+        const int* predK = &pred[at(k, 0)];
+
+        for (int i = first; i < n; i += step)
+        {
+            const double toK = costs[at(i, k)];
+            if(i == k or toK == inf())
+            {
+                continue;
+            }
+
+            double* rowI = &costs[at(i, 0)];
+            int* predI = &pred[at(i, 0)];
+            for (int j = 0; j < n; ++j)
+            {
+                const double candidate = toK + rowK[j];
+                const bool shorter = candidate < rowI[j];
+                rowI[j] = shorter ? candidate : rowI[j];
+                predI[j] = shorter ? predK[j] : predI[j];
+            }
+        }
+
+        if(barrier != NULL)
+        {
+            // row k+1 must be final before it is used by all threads
+            barrier->wait();
+        }
+    }
+
+    // convert the predecessor matrix into successor matrix: the first hop to
+    // j equals the first hop to the predecessor of j, if that is not i itself
+    std::vector<int> chain;
+    for (int i = first; i < n; i += step)
+    {
+        const int* predI = &pred[at(i, 0)];
+        int* nextI = &next[at(i, 0)];
+        std::vector<bool> known(n, false);
+        nextI[i] = i;
+        known[i] = true;
+
+        for (int j = 0; j < n; ++j)
+        {
+            if(known[j] or costs[at(i, j)] == inf())
+            {
+                continue;
+            }
+
+            int hop = j;
+            while(not known[hop] and predI[hop] != i)
+            {
+                chain.push_back(hop);
+                hop = predI[hop];
+                assure(chain.size() <= static_cast<size_t>(n), "Loop in predecessor matrix");
+            }
+            const int firstHopOut = known[hop] ? nextI[hop] : hop;
+            nextI[hop] = firstHopOut;
+            known[hop] = true;
+            for (std::vector<int>::const_iterator itr = chain.begin(); itr != chain.end(); ++itr)
+            {
+                nextI[*itr] = firstHopOut;
+                known[*itr] = true;
+            }
+            chain.clear();
+        }
+    }
+}
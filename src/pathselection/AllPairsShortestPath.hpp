@@ -0,0 +1,329 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_PATHSELECTION_ALLPAIRSSHORTESTPATH_HPP
+#define WIFIMAC_PATHSELECTION_ALLPAIRSSHORTESTPATH_HPP
+
+#include <WIFIMAC/pathselection/Metric.hpp>
+
+#include <WNS/Assure.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <limits>
+
+namespace boost {
+    class barrier;
+}
+
+namespace wifimac { namespace pathselection {
+
+    /**
+     * @brief All-pairs shortest-path engine of the VirtualPathSelection
+     *
+     * Stores the (unidirectional) link costs between the registered nodes and
+     * derives the path cost and next hop matrices from them. Only links which
+     * exist in both directions are used for forwarding, i.e. the effective
+     * weight of a link i->j is its link cost if also j->i exists, inf
+     * otherwise.
+     *
+     * Link changes are collected until the matrices are updated. They can
+     * either be computed from scratch with the Floyd-Warshall algorithm in
+     * O(n^3), or be repaired incrementally for each changed link:
+     * - A decrease of the effective weight is handled in O(n^2) by checking
+     *   for every pair if the path over the changed link is shorter.
+     * - An increase of the effective weight only affects the pairs whose
+     *   current path uses the changed link. For every destination, the set of
+     *   affected sources is determined by the next hop matrix and their paths
+     *   are recomputed by a Dijkstra search seeded from the unaffected nodes.
+     *
+     * Internally, the nodes are numbered densely in the order of their
+     * registration. All matrices are stored row-major in flat arrays with
+     * this dense numbering, costs as plain doubles with inf encoded as
+     * +infinity. Hence, the inner loops of the kernels run over contiguous
+     * memory without any branches for the inf handling, which allows the
+     * compiler to vectorize them.
+     *
+     * For each destination it is recorded whether any path cost or next hop
+     * towards it has changed, so that users can restrict their own
+     * postprocessing to these destinations.
+     *
+     * The full recomputation can be distributed over several threads: For a
+     * fixed intermediate node k, row k and column k of the path cost matrix
+     * do not change, so all other rows are relaxed independently. Each thread
+     * relaxes an interleaved subset of rows and waits at a barrier for the
+     * others before proceeding to the next k. Every entry is computed with
+     * the same operands in the same order as in the serial case, hence the
+     * result is bit-identical for any number of threads. The worker threads
+     * are started with the first parallel recomputation and kept until the
+     * engine is destroyed. An exception in a worker is passed on to the
+     * caller of recompute() as a wns::Exception.
+     */
+    class AllPairsShortestPath
+    {
+    public:
+        /**
+         * @brief Create an empty engine for node ids in [0, numNodes)
+         *
+         * At most numThreads threads are used for the full recomputation.
+         */
+        explicit
+        AllPairsShortestPath(int numNodes, int numThreads = 1);
+
+        ~AllPairsShortestPath();
+
+        /**
+         * @brief Add a node to the graph, the path cost to itself is zero
+         *
+         * The order in which nodes are added determines the order of the
+         * Floyd-Warshall iterations and thereby the choice between paths of
+         * equal cost.
+         */
+        void
+        addNode(int id);
+
+        /**
+         * @brief Set the link cost from->to without updating the path matrices
+         *
+         * The change is applied with the next call to update() or
+         * recompute().
+         */
+        void
+        setLinkCost(int from, int to, const Metric& cost);
+
+        /**
+         * @brief Repair the path matrices for all links changed since the last
+         * update
+         *
+         * The links are processed one after another. If more links have
+         * changed than nodes are known, the repair is more expensive than a
+         * full recomputation, which is performed instead.
+         */
+        void
+        update();
+
+        /**
+         * @brief Recompute all path costs and next hops from scratch
+         */
+        void
+        recompute();
+
+        /**
+         * @brief Compare the current path costs with a full recomputation
+         *
+         * Returns true if all path costs match within the relative
+         * tolerance. Otherwise, the result of the full recomputation replaces
+         * the current matrices and false is returned.
+         */
+        bool
+        verify(double tolerance);
+
+        Metric
+        getLinkCost(int from, int to) const
+            { return toMetric(linkCosts[at(position(from), position(to))]); }
+
+        Metric
+        getPathCost(int from, int to) const
+            { return toMetric(pathCosts[at(position(from), position(to))]); }
+
+        /**
+         * @brief First hop on the path from->to, only valid if the path cost
+         * is not inf
+         */
+        int
+        getNextHop(int from, int to) const
+            { return nodes[nextHops[at(position(from), position(to))]]; }
+
+        /**
+         * @brief True if a path cost or next hop towards the node has changed
+         * since the last call to clearChangedPaths()
+         */
+        bool
+        pathsChangedTo(int to) const
+            { return changedDestinations[position(to)]; }
+
+        void
+        clearChangedPaths()
+            { std::fill(changedDestinations.begin(), changedDestinations.end(), 0); }
+
+    private:
+        /**
+         * @brief Persistent threads for the parallel Floyd-Warshall
+         */
+        class Workers;
+
+        // the workers refer to this engine
+        AllPairsShortestPath(const AllPairsShortestPath&);
+        AllPairsShortestPath& operator=(const AllPairsShortestPath&);
+
+        /**
+         * @brief Classification of sources during the repair after a weight
+         * increase
+         */
+        enum NodeState { unknown, affected, unaffected };
+
+        static double
+        inf()
+            { return std::numeric_limits<double>::infinity(); }
+
+        static Metric
+        toMetric(double cost)
+            { return (cost == inf()) ? Metric() : Metric(cost); }
+
+        /**
+         * @brief Dense position of the node id
+         */
+        int
+        position(int id) const
+            {
+                assure(id >= 0 and id < numNodes and positions[id] != -1, "Unknown node id " << id);
+                return positions[id];
+            }
+
+        /**
+         * @brief Index of the entry (row, column) in the flat matrices
+         */
+        size_t
+        at(int row, int column) const
+            { return static_cast<size_t>(row) * numNodes + column; }
+
+        /**
+         * @brief Effective weight of the link from->to as derived from the
+         * link costs
+         */
+        double
+        effectiveWeight(int from, int to) const;
+
+        /**
+         * @brief Apply the change of the link from->to, which can also change
+         * the effective weight of the reverse link
+         */
+        void
+        applyLinkChange(int from, int to);
+
+        /**
+         * @brief Set the effective weight of a single link and repair the path
+         * matrices
+         */
+        void
+        changeWeight(int from, int to, double weight);
+
+        void
+        onWeightDecrease(int from, int to);
+
+        void
+        onWeightIncrease(int from, int to);
+
+        /**
+         * @brief Floyd-Warshall on the effective weights
+         */
+        void
+        floydWarshall(std::vector<double>& costs, std::vector<int>& next);
+
+        /**
+         * @brief Replace the path matrices by costs and next, recording the
+         * destinations whose entries differ
+         */
+        void
+        replacePaths(std::vector<double>& costs, std::vector<int>& next);
+
+        /**
+         * @brief Floyd-Warshall and successor conversion for the rows first,
+         * first+step, ...
+         *
+         * If barrier is given, it is passed after each intermediate node.
+         */
+        void
+        computeRows(std::vector<double>& costs,
+                    std::vector<int>& pred,
+                    std::vector<int>& next,
+                    int first,
+                    int step,
+                    boost::barrier* barrier) const;
+
+        /**
+         * @brief Minimum number of rows per thread, smaller matrices are
+         * computed with less threads
+         */
+        static const int minRowsPerThread = 32;
+
+        const int numNodes;
+
+        const int numThreads;
+
+        /**
+         * @brief Node ids in the order of their registration, i.e. by dense
+         * position
+         */
+        std::vector<int> nodes;
+
+        /**
+         * @brief Dense position of each node id, -1 if unknown
+         */
+        std::vector<int> positions;
+
+        /**
+         * @brief Links (dense positions) whose cost was set since the last
+         * update
+         */
+        std::vector<std::pair<int, int> > pendingLinks;
+
+        /**
+         * @brief Configured link costs (unidirectional)
+         */
+        std::vector<double> linkCosts;
+        /**
+         * @brief Effective link weights used by the path computation
+         */
+        std::vector<double> weights;
+        /**
+         * @brief Cost of the shortest path
+         */
+        std::vector<double> pathCosts;
+        /**
+         * @brief Dense position of the first hop of the shortest path
+         */
+        std::vector<int> nextHops;
+        /**
+         * @brief Per destination (dense position) non-zero if any path towards
+         * it has changed
+         */
+        std::vector<char> changedDestinations;
+
+        /**
+         * @brief Worker threads of the last parallel recomputation, NULL if
+         * none was needed yet
+         */
+        Workers* workers;
+    };
+
+} // pathselection
+} // wifimac
+
+#endif // WIFIMAC_PATHSELECTION_ALLPAIRSSHORTESTPATH_HPP
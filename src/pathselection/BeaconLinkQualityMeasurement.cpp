@@ -236,7 +236,8 @@ BeaconLinkQualityMeasurement::BeaconLinkQualityMeasurement(wns::ldk::fun::FUN* f
     logger(_config.get("logger")),
     config(_config),
     beaconInterval(config.get<wns::simulator::Time>("beaconInterval")),
-    phyUserCommandName(config.get<std::string>("phyUserCommandName"))
+    phyUserCommandName(config.get<std::string>("phyUserCommandName")),
+    phyUserReader(NULL)
 {
     friends.manager = NULL;
 
@@ -263,6 +264,7 @@ BeaconLinkQualityMeasurement::~BeaconLinkQualityMeasurement()
 void
 BeaconLinkQualityMeasurement::onFUNCreated()
 {
+    phyUserReader = getFUN()->getCommandReader(phyUserCommandName);
     friends.manager =  getFUN()->findFriend<wifimac::lowerMAC::Manager*>(config.get<std::string>("managerName"));
     assure(friends.manager, "Management entity not found");
 
@@ -341,7 +343,7 @@ BeaconLinkQualityMeasurement::doOnData(const wns::ldk::CompoundPtr& compound)
         // this link-measurement frame is consumed here
         BeaconLinkQualityMeasurementCommand* blqm = getCommand(compound->getCommandPool());
         wifimac::convergence::PhyUserCommand* puc =
-            getFUN()->getCommandReader(phyUserCommandName)->readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool());
+            phyUserReader->readCommand<wifimac::convergence::PhyUserCommand>(compound->getCommandPool());
 
         if(!linkQualities.knows(friends.manager->getTransmitterAddress(compound->getCommandPool())))
         {
@@ -31,10 +31,77 @@
 
 #include <WNS/ldk/Command.hpp>
 #include <WNS/service/dll/Address.hpp>
+#include <WNS/Assure.hpp>
 
 
 namespace wifimac { namespace pathselection {
 
+    /**
+     * @brief Fixed-capacity storage of the hops a frame has passed
+     *
+     * The addresses are stored inline, so that copying the ForwardingCommand
+     * does not allocate. Hops beyond the capacity are only counted.
+     */
+    class HopTrace
+    {
+    public:
+        /** @brief Number of stored hops, enough for the default mesh TTL */
+        static const unsigned int capacity = 32;
+
+        HopTrace():
+            numHops(0)
+            {}
+
+        void
+        push_back(const wns::service::dll::UnicastAddress& adr)
+            {
+                if(numHops < capacity)
+                {
+                    hops[numHops] = adr;
+                }
+                ++numHops;
+            }
+
+        void
+        clear()
+            {
+                numHops = 0;
+            }
+
+        /** @brief Number of stored hops */
+        unsigned int
+        size() const
+            {
+                if(numHops < capacity)
+                {
+                    return numHops;
+                }
+                return capacity;
+            }
+
+        /** @brief Number of hops that did not fit into the trace */
+        unsigned int
+        numDropped() const
+            {
+                if(numHops < capacity)
+                {
+                    return 0;
+                }
+                return numHops - capacity;
+            }
+
+        const wns::service::dll::UnicastAddress&
+        operator[](unsigned int hop) const
+            {
+                assure(hop < size(), "hop " << hop << " is not stored");
+                return hops[hop];
+            }
+
+    private:
+        wns::service::dll::UnicastAddress hops[capacity];
+        unsigned int numHops;
+    };
+
     class ForwardingCommand :
         public wns::ldk::Command
     {
@@ -117,7 +184,7 @@ namespace wifimac { namespace pathselection {
             /**
              * @brief Storage of the hops this frame has passed so far.
              */
-            std::vector<wns::service::dll::UnicastAddress> path;
+            HopTrace path;
 
             /**
              * @brief Number of hops this frame has passed so far
@@ -115,8 +115,10 @@ MeshForwarding::doOnData(const wns::ldk::CompoundPtr& _compound)
 {
     // Received compound from one of my transceivers
 
-    // First: copy the compound
-    wns::ldk::CompoundPtr compound = _compound->copy();
+    // The commands are manipulated below, hence work on a copy unless the
+    // received compound is not referenced by anybody else
+    wns::ldk::CompoundPtr compound =
+        (_compound->getRefCount() == 1) ? _compound : _compound->copy();
 
     ForwardingCommand* fc = getCommand(compound);
     dll::UpperCommand* uc = getFUN()->getProxy()->getCommand<dll::UpperCommand>(compound->getCommandPool(), ucName);
@@ -616,6 +618,10 @@ MeshForwarding::printForwardingInformation(ForwardingCommand* fc, dll::UpperComm
     {
         m << " " << fc->magic.path[hop];
     }
+    if(fc->magic.path.numDropped() > 0)
+    {
+        m << " (+" << fc->magic.path.numDropped() << " more)";
+    }
 
     if(((fc->peer.fromDS == true) &&
         (fc->peer.originalSource == layer2->getDLLAddress()))
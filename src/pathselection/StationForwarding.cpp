@@ -93,8 +93,10 @@ StationForwarding::doOnData(const wns::ldk::CompoundPtr& _compound)
 {
 	// Received compound from a transceiver
 
-	// First: copy the compound
-	wns::ldk::CompoundPtr compound = _compound->copy();
+	// The commands are manipulated below, hence work on a copy unless the
+	// received compound is not referenced by anybody else
+	wns::ldk::CompoundPtr compound =
+		(_compound->getRefCount() == 1) ? _compound : _compound->copy();
 
 	ForwardingCommand* fc = getCommand(compound);
 	dll::UpperCommand* uc = getFUN()->getProxy()->getCommand<dll::UpperCommand>(compound->getCommandPool(), ucName);
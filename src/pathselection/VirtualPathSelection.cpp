@@ -35,6 +35,10 @@
 #include <WNS/pyconfig/Sequence.hpp>
 #include <WNS/Ttos.hpp>
 
+#include <boost/bind.hpp>
+
+#include <algorithm>
+
 using namespace wifimac::pathselection;
 
 STATIC_FACTORY_REGISTER_WITH_CREATOR(
@@ -70,7 +74,17 @@ VirtualPathSelection::VirtualPathSelection(wns::node::Interface* _node,	const wn
 	logger(_config.get("logger")),
 	numNodes(_config.get<int>("numNodes")),
 	useStaticPS(_config.get<bool>("useStaticPS")),
-	pathMatrixIsConsistent(true)
+	shortestPaths(_config.get<int>("numNodes"), _config.get<int>("numThreads")),
+	pathMatrixIsConsistent(true),
+	incrementalUpdate(_config.get<bool>("incrementalUpdate")),
+	verifyIncrementalUpdate(_config.get<bool>("verifyIncrementalUpdate")),
+	verifyTolerance(_config.get<double>("verifyTolerance")),
+	deferredUpdate(_config.get<bool>("deferredUpdate")),
+	updateScheduled(false),
+	meshPoints(_config.get<int>("numNodes"), false),
+	portalUCs(_config.get<int>("numNodes"), NULL),
+	proxies2portals(_config.get<int>("numNodes"), 0),
+	proxyPortalIsValid(_config.get<int>("numNodes"), false)
 {
 	if (useStaticPS)
 	{
@@ -81,12 +95,7 @@ VirtualPathSelection::VirtualPathSelection(wns::node::Interface* _node,	const wn
 
 	// Initialize path and cost matrices
 	assure(numNodes > 0, "numNodes is below or equal to zero");
-	const addressMatrix::SizeType sizesAM[2] = {numNodes, numNodes};
-	paths = addressMatrix(sizesAM, 0);
-
 	const metricMatrix::SizeType sizesMM[2] = {numNodes, numNodes};
-	linkCosts = metricMatrix(sizesMM, Metric());
-	pathCosts = metricMatrix(sizesMM, Metric());
 
     if(_config.knows("preKnowledge"))
     {
@@ -132,9 +141,10 @@ VirtualPathSelection::registerMP(const wns::service::dll::UnicastAddress mpAddre
 	int id = mapper.map(mpAddress);
 	// store mp address
 	mps.push_back(id);
+	meshPoints[id] = true;
 
 	// set path to itself
-	linkCosts[id][id] = 0;
+	shortestPaths.addNode(id);
 
 	MESSAGE_SINGLE(NORMAL, logger, "Added MP " << mpAddress << " to list of MPs, now " << mps.size());
 }
@@ -157,19 +167,24 @@ VirtualPathSelection::registerPortal(const wns::service::dll::UnicastAddress por
 
 	// first: every portal is also a mp
 	mps.push_back(id);
+	meshPoints[id] = true;
+
+    // set path to itself
+	shortestPaths.addNode(id);
 
 	// set link costs from/to any other portal to zero
 	for(adr2ucMap::const_iterator itr = portals.begin(); itr != portals.end(); ++itr)
 	{
-		linkCosts[itr->first][id] = 0;
-		linkCosts[id][itr->first] = 0;
+		shortestPaths.setLinkCost(itr->first, id, 0);
+		shortestPaths.setLinkCost(id, itr->first, 0);
 	}
 
-    // set path to itself
-	linkCosts[id][id] = 0;
-
 	// store portal address
 	portals[id] = apUC;
+	portalUCs[id] = apUC;
+
+	// the new portal can be a better choice for any proxy
+	std::fill(proxyPortalIsValid.begin(), proxyPortalIsValid.end(), false);
 
 	MESSAGE_SINGLE(NORMAL, logger, "Added Portal " << portalAddress << " to list of Portals, now " << portals.size());
 }
@@ -187,35 +202,35 @@ VirtualPathSelection::getNextHop(const wns::service::dll::UnicastAddress current
 
 	assure(current.isValid(), "current is not valid");
 	assure(finalDestination.isValid(), "finalDestination is not valid");
-	assure(isMeshPoint(current), "getNextHop: unknown MP " << current);
 	assure(current != finalDestination, "Already reached finalDestination");
 
-	wns::service::dll::UnicastAddress fD;
-	if (isMeshPoint(finalDestination))
-	{
-		fD = finalDestination;
-	}
-	else
+	const int currentId = mapper.find(current);
+	assure(isMeshPointId(currentId), "getNextHop: unknown MP " << current);
+
+	int fDId = mapper.find(finalDestination);
+	if (not isMeshPointId(fDId))
 	{
-		assure(isMeshPoint(getProxyFor(finalDestination)), finalDestination << " is neither known MP nor proxied by a known MP");
-		fD = getProxyFor(finalDestination);
-		MESSAGE_SINGLE(NORMAL, logger, "getNextHop: finalDestination " << finalDestination << " is proxied by " << fD);
+		fDId = getProxyId(fDId);
+		assure(isMeshPointId(fDId), finalDestination << " is neither known MP nor proxied by a known MP");
+		MESSAGE_SINGLE(NORMAL, logger, "getNextHop: finalDestination " << finalDestination << " is proxied by " << mapper.get(fDId));
 	}
 
-	if(pathCosts[mapper.get(current)][mapper.get(fD)].isInf())
+	if(shortestPaths.getPathCost(currentId, fDId).isInf())
 	{
-		MESSAGE_SINGLE(NORMAL, logger, "getNextHop query from " << current << " to " << fD << " is unknown");
+		MESSAGE_SINGLE(NORMAL, logger, "getNextHop query from " << current << " to " << mapper.get(fDId) << " is unknown");
         //this->printPathSelectionTable();
 		return wns::service::dll::UnicastAddress();
 	}
 	else
 	{
+		const wns::service::dll::UnicastAddress nextHop = mapper.get(shortestPaths.getNextHop(currentId, fDId));
+
 		MESSAGE_BEGIN(VERBOSE, logger, m, "getNextHop query from ");
-		m << current << " to "<< fD;
-		m << " --> " << mapper.get(paths[mapper.get(current)][mapper.get(fD)]) << " with total pathcost " << pathCosts[mapper.get(current)][mapper.get(fD)];
+		m << current << " to "<< mapper.get(fDId);
+		m << " --> " << nextHop << " with total pathcost " << shortestPaths.getPathCost(currentId, fDId);
 		MESSAGE_END();
 
-		return(mapper.get(paths[mapper.get(current)][mapper.get(fD)]));
+		return(nextHop);
 	}
 }
 
@@ -224,22 +239,7 @@ VirtualPathSelection::isMeshPoint(const wns::service::dll::UnicastAddress addres
 {
 	assure(address.isValid(), "address is not valid");
 
-	int id;
-	if(!mapper.knows(address))
-	{
-		return false;
-	}
-	id = mapper.get(address);
-
-	addressList::const_iterator itr;
-	for (itr = mps.begin(); itr != mps.end(); ++itr)
-	{
-		if(*itr == id)
-		{
-			return true;
-		}
-	}
-	return false;
+	return(isMeshPointId(mapper.find(address)));
 }
 
 bool
@@ -247,22 +247,7 @@ VirtualPathSelection::isPortal(const wns::service::dll::UnicastAddress address)
 {
 	assure(address.isValid(), "address is not valid");
 
-	int id;
-	if(!mapper.knows(address))
-	{
-		return false;
-	}
-	id = mapper.get(address);
-
-	adr2ucMap::const_iterator itr;
-	for (itr = portals.begin(); itr != portals.end(); ++itr)
-	{
-		if(itr->first == id)
-		{
-			return true;
-		}
-	}
-	return false;
+	return(isPortalId(mapper.find(address)));
 }
 
 wns::service::dll::UnicastAddress
@@ -278,27 +263,19 @@ VirtualPathSelection::getPortalFor(const wns::service::dll::UnicastAddress clien
 	}
 
 
-	int id;
-	if(!mapper.knows(clientAddress))
+	const int portalId = getPortalId(mapper.find(clientAddress));
+	if(portalId == 0)
 	{
-		// unknown id
+		// unknown id or not found in list
 		return wns::service::dll::UnicastAddress();
 	}
-	id = mapper.get(clientAddress);
 
-	addressMap::const_iterator itr = clients2portals.find(id);
-	if(itr == clients2portals.end())
-	{
-		// not found in list
-		return wns::service::dll::UnicastAddress();
-	}
-
-	assure(isMeshPoint(mapper.get(itr->second)), mapper.get(itr->second) << " is not a known MP");
-	assure(isPortal(mapper.get(itr->second)), mapper.get(itr->second) << " is not a known Portal");
+	assure(isMeshPointId(portalId), mapper.get(portalId) << " is not a known MP");
+	assure(isPortalId(portalId), mapper.get(portalId) << " is not a known Portal");
 
-	MESSAGE_SINGLE(NORMAL, logger, "getPortalFor: portal for " << clientAddress << " is known to be " << mapper.get(itr->second));
+	MESSAGE_SINGLE(NORMAL, logger, "getPortalFor: portal for " << clientAddress << " is known to be " << mapper.get(portalId));
 
-	return(mapper.get(itr->second));
+	return(mapper.get(portalId));
 }
 
 wns::service::dll::UnicastAddress
@@ -312,26 +289,18 @@ VirtualPathSelection::getProxyFor(const wns::service::dll::UnicastAddress client
 		this->onNewPathSelectionEntry();
 	}
 
-	int id;
-	if(!mapper.knows(clientAddress))
+	const int proxyId = getProxyId(mapper.find(clientAddress));
+	if(proxyId == 0)
 	{
-		// unknown id
+		// unknown id or not found in list
 		return wns::service::dll::UnicastAddress();
 	}
-	id = mapper.get(clientAddress);
 
-	addressMap::const_iterator itr = clients2proxies.find(id);
-	if(itr == clients2proxies.end())
-	{
-		// not found in list
-		return wns::service::dll::UnicastAddress();
-	}
-
-	assure(isMeshPoint(mapper.get(itr->second)), mapper.get(itr->second) << " is not a known MP");
+	assure(isMeshPointId(proxyId), mapper.get(proxyId) << " is not a known MP");
 
-	MESSAGE_SINGLE(NORMAL, logger, "getProxyFor: proxy for " << clientAddress << " is known to be " << mapper.get(itr->second));
+	MESSAGE_SINGLE(NORMAL, logger, "getProxyFor: proxy for " << clientAddress << " is known to be " << mapper.get(proxyId));
 
-	return(mapper.get(itr->second));
+	return(mapper.get(proxyId));
 }
 
 
@@ -362,35 +331,34 @@ VirtualPathSelection::registerProxy(const wns::service::dll::UnicastAddress prox
 	int clientId = mapper.map(client);
 	int proxyId = mapper.get(proxy);
 
+	if(static_cast<size_t>(clientId) >= clients2proxies.size())
+	{
+		clients2proxies.resize(clientId + 1, 0);
+		clients2portals.resize(clientId + 1, 0);
+	}
+
 	clients2proxies[clientId] = proxyId;
 	MESSAGE_SINGLE(NORMAL, logger, "registered " << proxy << " as proxy for " << client);
 
-	if(isPortal(proxy))
+	if(isPortalId(proxyId))
 	{
 		// The best portal is always the proxy itself
 		// tell it to the RANG
-		portals.find(proxyId)->second->getRANG()->updateAPLookUp(client, portals.find(proxyId)->second);
+		portalUCs[proxyId]->getRANG()->updateAPLookUp(client, portalUCs[proxyId]);
 		clients2portals[clientId] = proxyId;
 		MESSAGE_SINGLE(NORMAL, logger, "set portal for " << client << " to " << proxy);
 		return;
 	}
 
 	// search the best portal for the new client
-	// Attention: As the cost for portal->portal is zero, all portals have the same (minimum) cost
-	// Hence, we search for the first portal from which the first hop to the proxy is not another portal
-	for(adr2ucMap::iterator itr = portals.begin(); itr != portals.end(); ++itr)
+	const int portalId = getBestPortalId(proxyId);
+	if(portalId != 0)
 	{
-		if(getNextHop(mapper.get(itr->first), proxy).isValid() and !isPortal(getNextHop(mapper.get(itr->first), proxy)))
-		{
-			assure(pathCosts[proxyId][itr->first].isNotInf(), "Path cost from proxy to portal is inf -> network is not connected");
-			assure(pathCosts[itr->first][proxyId].isNotInf(), "Path cost from portal to proxy is inf -> network is not connected");
-
-			// tell it to the RANG
-			portals.find(itr->first)->second->getRANG()->updateAPLookUp(client, portals.find(itr->first)->second);
-			clients2portals[clientId] = itr->first;
-			MESSAGE_SINGLE(NORMAL, logger, "set portal for " << client << " to " << mapper.get(itr->first));
-			return;
-		}
+		// tell it to the RANG
+		portalUCs[portalId]->getRANG()->updateAPLookUp(client, portalUCs[portalId]);
+		clients2portals[clientId] = portalId;
+		MESSAGE_SINGLE(NORMAL, logger, "set portal for " << client << " to " << mapper.get(portalId));
+		return;
 	}
 	MESSAGE_SINGLE(NORMAL, logger, "no portal for client " << client << " available at this moment");
 }
@@ -414,14 +382,10 @@ VirtualPathSelection::deRegisterProxy(const wns::service::dll::UnicastAddress
 	assure(mapper.knows(proxy), "proxy address is not known");
 	assure(getProxyFor(client) == proxy, "MP " << proxy << " is not a proxy for " << client << " --> cannot deRegisterProxy");
 
-	addressMap::iterator itr = clients2proxies.find(mapper.get(client));
-	if(itr == clients2proxies.end())
-	{
-		// not found in list
-		assure(false, "trying to deRegister " << client << " but it has no proxy");
-	}
+	const int clientId = mapper.get(client);
+	assure(getProxyId(clientId) != 0, "trying to deRegister " << client << " but it has no proxy");
 
-	clients2proxies.erase(itr);
+	clients2proxies[clientId] = 0;
 	MESSAGE_SINGLE(NORMAL, logger, "DEregistered " << proxy << " as proxy for " << client);
 
 }
@@ -453,7 +417,7 @@ VirtualPathSelection::createPeerLink(const wns::service::dll::UnicastAddress mys
         int myselfId = mapper.get(myself);
         int peerId = mapper.get(peer);
 
-		assure(linkCosts[myselfId][peerId].isInf(), "createPeerLink with already known linkCosts");
+		assure(shortestPaths.getLinkCost(myselfId, peerId).isInf(), "createPeerLink with already known linkCosts");
 
         Metric newLinkMetric = linkMetric;
         if(preKnowledgeCosts[myselfId][peerId].isNotInf())
@@ -462,12 +426,8 @@ VirtualPathSelection::createPeerLink(const wns::service::dll::UnicastAddress mys
             MESSAGE_SINGLE(NORMAL, logger, "createPeerLink: " << myself << "->" << peer << " has preKnowledge of " << preKnowledgeCosts[myselfId][peerId] << ", " << linkMetric << "->" << newLinkMetric);
         }
 
-        linkCosts[myselfId][peerId] = newLinkMetric;
-
-
-        MESSAGE_SINGLE(NORMAL, logger, "createPeerLink: " << myself << " --> " << peer << " costs " << linkCosts[myselfId][peerId]);
-		pathMatrixIsConsistent = false;
-        onNewPathSelectionEntry();
+        MESSAGE_SINGLE(NORMAL, logger, "createPeerLink: " << myself << " --> " << peer << " costs " << newLinkMetric);
+        setLinkCost(myselfId, peerId, newLinkMetric);
 	}
 }
 
@@ -491,7 +451,7 @@ VirtualPathSelection::updatePeerLink(const wns::service::dll::UnicastAddress mys
     int myselfId = mapper.get(myself);
     int peerId = mapper.get(peer);
 
-    if(linkCosts[myselfId][peerId].isInf())
+    if(shortestPaths.getLinkCost(myselfId, peerId).isInf())
     {
         throw wns::Exception("cannot update a link which has costs inf --> must be created first!");
     }
@@ -509,7 +469,7 @@ VirtualPathSelection::updatePeerLink(const wns::service::dll::UnicastAddress mys
         MESSAGE_SINGLE(NORMAL, logger, "updatePeerLink: " << myself << "->" << peer << " has preKnowledge of " << preKnowledgeCosts[myselfId][peerId] << ", " << linkMetric << "->" << newLinkMetric);
     }
 
-    if(linkCosts[myselfId][peerId] == newLinkMetric)
+    if(shortestPaths.getLinkCost(myselfId, peerId) == newLinkMetric)
     {
         // same values, no update required
         return;
@@ -517,14 +477,11 @@ VirtualPathSelection::updatePeerLink(const wns::service::dll::UnicastAddress mys
 
     MESSAGE_BEGIN(NORMAL, logger, m, "updatePeerLink: ");
     m << myself << " --> " << peer;
-    m << " from costs " << linkCosts[myselfId][peerId];
+    m << " from costs " << shortestPaths.getLinkCost(myselfId, peerId);
     m << " to " << newLinkMetric;
     MESSAGE_END();
 
-    linkCosts[myselfId][peerId] = newLinkMetric;
-
-    pathMatrixIsConsistent = false;
-    onNewPathSelectionEntry();
+    setLinkCost(myselfId, peerId, newLinkMetric);
 }
 
 void
@@ -546,7 +503,7 @@ VirtualPathSelection::closePeerLink(const wns::service::dll::UnicastAddress myse
 	int myselfId = mapper.get(myself);
 	int peerId = mapper.get(peer);
 
-	if(linkCosts[myselfId][peerId].isInf())
+	if(shortestPaths.getLinkCost(myselfId, peerId).isInf())
 	{
 		throw wns::Exception("cannot close a link which has costs inf --> must be created first!");
 	}
@@ -557,126 +514,114 @@ VirtualPathSelection::closePeerLink(const wns::service::dll::UnicastAddress myse
 		return;
 	}
 
-	linkCosts[myselfId][peerId] = Metric();
+	setLinkCost(myselfId, peerId, Metric());
+}
+
+void
+VirtualPathSelection::setLinkCost(const int myselfId, const int peerId, const Metric& linkMetric)
+{
+    shortestPaths.setLinkCost(myselfId, peerId, linkMetric);
+    pathMatrixIsConsistent = false;
 
-	pathMatrixIsConsistent = false;
-    onNewPathSelectionEntry();
+    if(not deferredUpdate)
+    {
+        onNewPathSelectionEntry();
+        return;
+    }
+
+    // collect all link changes of the current simulation time, queries in
+    // the meantime trigger the computation on demand
+    if(not updateScheduled)
+    {
+        updateScheduled = true;
+        wns::simulator::getEventScheduler()->scheduleDelay(
+            boost::bind(&wifimac::pathselection::VirtualPathSelection::onDeferredUpdate, this),
+            0.0);
+    }
 }
 
 void
-VirtualPathSelection::onNewPathSelectionEntry()
+VirtualPathSelection::onDeferredUpdate()
 {
-    const addressMatrix::SizeType sizesMM[2] = {numNodes, numNodes};
-    addressMatrix pred = addressMatrix(sizesMM, 0);
+    updateScheduled = false;
+
+    if(!pathMatrixIsConsistent)
+    {
+        this->onNewPathSelectionEntry();
+    }
+}
 
-    // initialize predecessor and pathCost matrix:
-    //   * predecessor: If direct link exists, predecessor is source itself
-    //   * pathCost: Same as linkCost if the link is bidirectional, inf
-    //     otherwise
-    pathCosts = linkCosts;
+void
+VirtualPathSelection::onNewPathSelectionEntry()
+{
     for (addressList::const_iterator i = mps.begin(); i != mps.end(); ++i)
     {
         MESSAGE_BEGIN(VERBOSE, logger, m, "lc " << *i << ":");
         for (addressList::const_iterator j = mps.begin(); j != mps.end(); ++j)
         {
-            m << " " << *j << ":" << linkCosts[*i][*j];
+            m << " " << *j << ":" << shortestPaths.getLinkCost(*i, *j);
         }
         MESSAGE_END();
     }
 
-    for (addressList::const_iterator i = mps.begin(); i != mps.end(); ++i)
+    if(not incrementalUpdate)
     {
-        for (addressList::const_iterator j = mps.begin(); j != mps.end(); ++j)
-        {
-            if((*i != *j) and (linkCosts[*i][*j].isNotInf()))
-            {
-                pred[*i][*j] = *i;
-            }
-            if((*i != *j) and (linkCosts[*i][*j].isNotInf()) and (linkCosts[*j][*i].isInf()))
-            {
-                pathCosts[*i][*j] = Metric();
-            }
-        }
+        // full recomputation in O(nodes^3)
+        shortestPaths.recompute();
     }
-
-    // Floyd-Warshall Algorithm to compute all-pairs shortest-path inclusive
-    // predecessor matrix in O(nodes^3)
-    for (addressList::const_iterator k = mps.begin(); k != mps.end(); ++k)
+    else
     {
-        for (addressList::const_iterator i = mps.begin(); i != mps.end(); ++i)
+        // repair only the entries affected by the changed links
+        shortestPaths.update();
+
+        if(verifyIncrementalUpdate and not shortestPaths.verify(verifyTolerance))
         {
-            for (addressList::const_iterator j = mps.begin(); j != mps.end(); ++j)
-            {
-                if(pathCosts[*i][*k].isNotInf() and pathCosts[*k][*j].isNotInf())
-                {
-                    if(pathCosts[*i][*k] + pathCosts[*k][*j] < pathCosts[*i][*j])
-                    {
-                        pathCosts[*i][*j] = pathCosts[*i][*k] + pathCosts[*k][*j];
-                        assure(pathCosts[*i][*j] >= 0, "found negative cycle in graph");
-
-                        pred[*i][*j] = pred[*k][*j];
-                    }
-                }
-            }
+            MESSAGE_SINGLE(NORMAL, logger, "Incremental update deviates from full recomputation, using the latter");
         }
     }
 
-    // convert the predecessor matrix into successor matrix paths
-    for (addressList::const_iterator i = mps.begin(); i != mps.end(); ++i)
+    pathMatrixIsConsistent = true;
+
+    // the best portal has to be searched again only for proxies to which
+    // any path has changed
+    for (addressList::const_iterator itr = mps.begin(); itr != mps.end(); ++itr)
     {
-        for (addressList::const_iterator j = mps.begin(); j != mps.end(); ++j)
+        if(shortestPaths.pathsChangedTo(*itr))
         {
-            if((*i != *j) && (pathCosts[*i][*j].isNotInf()))
-            {
-                int firstHopOut = *j;
-
-                while(pred[*i][firstHopOut] != *i)
-                {
-                    firstHopOut = pred[*i][firstHopOut];
-                }
-                paths[*i][*j] = firstHopOut;
-            }
+            proxyPortalIsValid[*itr] = false;
         }
     }
-
-    pathMatrixIsConsistent = true;
+    shortestPaths.clearChangedPaths();
 
     // update portal settings for the clients
     // iterate over all clients
-    for (addressMap::const_iterator clientsItr = clients2proxies.begin(); clientsItr != clients2proxies.end(); ++clientsItr)
+    for (size_t clientId = 1; clientId < clients2proxies.size(); ++clientId)
     {
+        const int proxyId = clients2proxies[clientId];
+        if(proxyId == 0)
+        {
+            continue;
+        }
+
         // if the proxy is the portal, it remains the portal
-        if(isPortal(mapper.get(clientsItr->second)))
+        if(isPortalId(proxyId))
         {
-            assure(clients2portals[clientsItr->first] == clientsItr->second,
-                   "Client " << mapper.get(clientsItr->first) <<
-                   " has proxy " << mapper.get(clientsItr->second) <<
-                   ", which is a portal but the client is assigned to the portal " << mapper.get(clients2portals[clientsItr->first]));
+            assure(clients2portals[clientId] == proxyId,
+                   "Client " << mapper.get(clientId) <<
+                   " has proxy " << mapper.get(proxyId) <<
+                   ", which is a portal but the client is assigned to the portal " << mapper.get(clients2portals[clientId]));
 
-            MESSAGE_SINGLE(NORMAL, logger, "portal for " << mapper.get(clientsItr->first) << " remains " << mapper.get(clientsItr->second) << " beause it is also its proxy");
+            MESSAGE_SINGLE(NORMAL, logger, "portal for " << mapper.get(clientId) << " remains " << mapper.get(proxyId) << " beause it is also its proxy");
             continue;
         }
 
-        // search the best (= lowest DL path cost) portal for the new client (clientsItr->first)
-        // Attention: As the cost for portal->portal is zero, all portals have the same (minimum) cost
-        // Hence, we search for the one portal from which the first hop to the proxy is not another portal
-        for(adr2ucMap::iterator portalsItr = portals.begin(); portalsItr != portals.end(); ++portalsItr)
+        // the best portal is determined once per proxy
+        const int portalId = getBestPortalId(proxyId);
+        if(portalId != 0 and portalId != clients2portals[clientId])
         {
-            if(getNextHop(mapper.get(portalsItr->first), mapper.get(clientsItr->second)).isValid() and !isPortal(getNextHop(mapper.get(portalsItr->first), mapper.get(clientsItr->second))))
-            {
-                assure(pathCosts[clientsItr->second][portalsItr->first].isNotInf(),
-                       "Path cost from proxy to portal is inf -> network is not connected");
-                assure(pathCosts[portalsItr->first][clientsItr->second].isNotInf(),
-                       "Path cost from portal to proxy is inf -> network is not connected");
-
-                if(portalsItr->first != clients2portals.find(clientsItr->first)->second)
-                {
-                    portalsItr->second->getRANG()->updateAPLookUp(mapper.get(clientsItr->first), portalsItr->second);
-                    clients2portals[clientsItr->first] = portalsItr->first;
-                    MESSAGE_SINGLE(NORMAL, logger, "change portal for " << mapper.get(clientsItr->first) << " to " << mapper.get(portalsItr->first));
-                }
-                break;
-            }
+            portalUCs[portalId]->getRANG()->updateAPLookUp(mapper.get(clientId), portalUCs[portalId]);
+            clients2portals[clientId] = portalId;
+            MESSAGE_SINGLE(NORMAL, logger, "change portal for " << mapper.get(clientId) << " to " << mapper.get(portalId));
         }
     }
 
@@ -685,6 +630,37 @@ VirtualPathSelection::onNewPathSelectionEntry()
 #endif
 }
 
+int
+VirtualPathSelection::getBestPortalId(const int proxyId)
+{
+    assure(isMeshPointId(proxyId), "proxy id " << proxyId << " is not a known MP");
+
+    if(proxyPortalIsValid[proxyId])
+    {
+        return(proxies2portals[proxyId]);
+    }
+
+    // search the best (= lowest DL path cost) portal for the proxy
+    // Attention: As the cost for portal->portal is zero, all portals have the same (minimum) cost
+    // Hence, we search for the one portal from which the first hop to the proxy is not another portal
+    int bestPortal = 0;
+    for(adr2ucMap::const_iterator itr = portals.begin(); itr != portals.end(); ++itr)
+    {
+        if(shortestPaths.getPathCost(itr->first, proxyId).isNotInf() and
+           (itr->first == proxyId or !isPortalId(shortestPaths.getNextHop(itr->first, proxyId))))
+        {
+            assure(shortestPaths.getPathCost(proxyId, itr->first).isNotInf(),
+                   "Path cost from proxy to portal is inf -> network is not connected");
+            bestPortal = itr->first;
+            break;
+        }
+    }
+
+    proxies2portals[proxyId] = bestPortal;
+    proxyPortalIsValid[proxyId] = true;
+    return(bestPortal);
+}
+
 void
 VirtualPathSelection::printPathSelectionTable() const
 {
@@ -712,7 +688,7 @@ void VirtualPathSelection::printPathSelectionLine(const wns::service::dll::Unica
     MESSAGE_BEGIN(VERBOSE, logger, m, "routing: ");
     for(addressList::const_iterator itr = mps.begin(); itr != mps.end(); ++itr)
     {
-        if(pathCosts[mapper.get(source)][*itr].isInf())
+        if(shortestPaths.getPathCost(mapper.get(source), *itr).isInf())
         {
             m << mapper.get(*itr) << " (Inf/-1)\t";
         }
@@ -724,7 +700,7 @@ void VirtualPathSelection::printPathSelectionLine(const wns::service::dll::Unica
             }
             else
             {
-                m << mapper.get(*itr) << " (" << pathCosts[mapper.get(source)][*itr].toDouble() << "/" << mapper.get(paths[mapper.get(source)][*itr]) << ")\t";
+                m << mapper.get(*itr) << " (" << shortestPaths.getPathCost(mapper.get(source), *itr).toDouble() << "/" << mapper.get(shortestPaths.getNextHop(mapper.get(source), *itr)) << ")\t";
             }
         }
     }
@@ -734,11 +710,11 @@ void VirtualPathSelection::printPathSelectionLine(const wns::service::dll::Unica
 void VirtualPathSelection::printProxyInformation(const wns::service::dll::UnicastAddress proxy) const
 {
 	MESSAGE_BEGIN(VERBOSE, logger, m, "proxied clients: ");
-	for(addressMap::const_iterator itr = clients2proxies.begin(); itr != clients2proxies.end(); ++itr)
+	for(size_t clientId = 1; clientId < clients2proxies.size(); ++clientId)
 	{
-		if(itr->second == mapper.get(proxy))
+		if(clients2proxies[clientId] == mapper.get(proxy))
 		{
-			m << mapper.get(itr->first) << " ";
+			m << mapper.get(clientId) << " ";
 		}
 	}
 	MESSAGE_END();
@@ -747,20 +723,19 @@ void VirtualPathSelection::printProxyInformation(const wns::service::dll::Unicas
 void VirtualPathSelection::printPortalInformation(const wns::service::dll::UnicastAddress portal) const
 {
 	MESSAGE_BEGIN(VERBOSE, logger, m, "portal for: ");
-	for(addressMap::const_iterator itr = clients2portals.begin(); itr != clients2portals.end(); ++itr)
+	for(size_t clientId = 1; clientId < clients2portals.size(); ++clientId)
 	{
-		if(itr->second == mapper.get(portal))
+		if(clients2portals[clientId] == mapper.get(portal))
 		{
-			m << mapper.get(itr->first) << " ";
+			m << mapper.get(clientId) << " ";
 		}
 	}
 	MESSAGE_END();
 }
 
 VirtualPathSelection::AddressStorage::AddressStorage() :
-	nextId(1),
 	adr2id(),
-	id2adr()
+	id2adr(1)
 {
 
 }
@@ -768,44 +743,54 @@ VirtualPathSelection::AddressStorage::AddressStorage() :
 int
 VirtualPathSelection::AddressStorage::map(const wns::service::dll::UnicastAddress adr)
 {
-    if(!adr2id.knows(adr))
+    IdLookup::const_iterator itr = adr2id.find(adr.getInteger());
+    if(itr == adr2id.end())
     {
-        assure(! id2adr.knows(nextId), "NextId already used?");
-        adr2id.insert(adr, nextId);
-        id2adr.insert(nextId, adr);
-        ++nextId;
-        return(nextId-1);
+        const int nextId = id2adr.size();
+        adr2id[adr.getInteger()] = nextId;
+        id2adr.push_back(adr);
+        return(nextId);
     }
 
-	return(adr2id.find(adr));
+	return(itr->second);
+}
+
+int
+VirtualPathSelection::AddressStorage::find(const wns::service::dll::UnicastAddress adr) const
+{
+    IdLookup::const_iterator itr = adr2id.find(adr.getInteger());
+    return((itr == adr2id.end()) ? 0 : itr->second);
 }
 
 int
 VirtualPathSelection::AddressStorage::get(const wns::service::dll::UnicastAddress adr) const
 {
-    return(adr2id.find(adr));
+    const int id = find(adr);
+    assure(id != 0, "Address " << adr << " is not known");
+    return(id);
 }
 
 wns::service::dll::UnicastAddress
 VirtualPathSelection::AddressStorage::get(const int id) const
 {
-    return(id2adr.find(id));
+    assure(knows(id), "Id " << id << " is not known");
+    return(id2adr[id]);
 }
 
 bool
 VirtualPathSelection::AddressStorage::knows(const wns::service::dll::UnicastAddress adr) const
 {
-    return(adr2id.knows(adr));
+    return(find(adr) != 0);
 }
 
 bool
 VirtualPathSelection::AddressStorage::knows(const int id) const
 {
-       return(id2adr.knows(id));
+       return((id > 0) and (static_cast<size_t>(id) < id2adr.size()));
 }
 
 int
 VirtualPathSelection::AddressStorage::getMaxId() const
 {
-	return(nextId-1);
+	return(id2adr.size()-1);
 }
@@ -31,19 +31,22 @@
 
 #include <WIFIMAC/pathselection/IPathSelection.hpp>
 #include <WIFIMAC/pathselection/Metric.hpp>
+#include <WIFIMAC/pathselection/AllPairsShortestPath.hpp>
 
 #include <DLL/UpperConvergence.hpp>
 
 #include <WNS/node/component/Component.hpp>
-#include <WNS/container/Registry.hpp>
 #include <WNS/ldk/fun/Main.hpp>
 #include <WNS/ldk/Layer.hpp>
 #include <WNS/logger/Logger.hpp>
 #include <WNS/Singleton.hpp>
 #include <WNS/container/Matrix.hpp>
 
+#include <boost/unordered_map.hpp>
+
 #include <map>
 #include <list>
+#include <vector>
 
 namespace wifimac { namespace pathselection {
 
@@ -80,8 +83,8 @@ namespace wifimac { namespace pathselection {
          */
         class AddressStorage
         {
-            typedef wns::container::Registry<wns::service::dll::UnicastAddress, int> IdLookup;
-            typedef wns::container::Registry<int, wns::service::dll::UnicastAddress> AdrLookup;
+            typedef boost::unordered_map<int, int> IdLookup;
+            typedef std::vector<wns::service::dll::UnicastAddress> AdrLookup;
 
         public:
             AddressStorage();
@@ -98,6 +101,12 @@ namespace wifimac { namespace pathselection {
             int
             get(const wns::service::dll::UnicastAddress adr) const;
 
+            /**
+             * @brief Convert adr to id, returns 0 if adr is unknown
+             */
+            int
+            find(const wns::service::dll::UnicastAddress adr) const;
+
             /**
              * @brief Convert id to adr
              */
@@ -124,16 +133,13 @@ namespace wifimac { namespace pathselection {
 
         private:
             /**
-             * @brief Counter for the next, unused id
-             */
-            int nextId;
-
-            /**
-             * @brief Map for adr to id
+             * @brief Hash map for the integer representation of adr to id
              */
             IdLookup adr2id;
+
             /**
-             * @brief Map for id to adr. Always consistent with adr2id
+             * @brief Vector indexed by id, entry 0 is unused. Always
+             * consistent with adr2id
              */
             AdrLookup id2adr;
         };
@@ -320,23 +326,70 @@ namespace wifimac { namespace pathselection {
 		 */
         void onNewPathSelectionEntry();
 
+        /**
+         * @brief Set the cost of the link from myselfId to peerId and update
+         * the path/cost matrix, either immediately or deferred
+         */
+        void setLinkCost(const int myselfId, const int peerId, const Metric& linkMetric);
+
+        /**
+         * @brief Scheduled once per simulation time with link changes in the
+         * deferred mode
+         */
+        void onDeferredUpdate();
+
+        /**
+         * @brief Best portal for the clients of the proxy, 0 if no portal is
+         * reachable
+         *
+         * The result is cached until a path towards the proxy changes or a new
+         * portal is registered.
+         */
+        int
+        getBestPortalId(const int proxyId);
+
+        /**
+         * @brief True if id belongs to a registered MP, false for unknown (0)
+         * ids
+         */
+        bool
+        isMeshPointId(const int id) const
+            { return (id > 0) and (id < numNodes) and meshPoints[id]; }
+
+        /**
+         * @brief True if id belongs to a registered portal
+         */
+        bool
+        isPortalId(const int id) const
+            { return (id > 0) and (id < numNodes) and (portalUCs[id] != NULL); }
+
+        /**
+         * @brief Proxy id of the client id, 0 if none is registered
+         */
+        int
+        getProxyId(const int clientId) const
+            { return (clientId > 0 and static_cast<size_t>(clientId) < clients2proxies.size()) ? clients2proxies[clientId] : 0; }
+
+        /**
+         * @brief Portal id of the client id, 0 if none is assigned
+         */
+        int
+        getPortalId(const int clientId) const
+            { return (clientId > 0 and static_cast<size_t>(clientId) < clients2portals.size()) ? clients2portals[clientId] : 0; }
+
         /**
 		 * @brief the logger
 		 */
         wns::logger::Logger logger;
 
-        /**
-		 * @brief 2-dim Matrix of ids
-		 */
-        typedef wns::container::Matrix<int, 2> addressMatrix;
         /**
 		 * @brief 2-dim Matrix of path/link costs
 		 */
         typedef wns::container::Matrix<Metric, 2> metricMatrix;
         /**
-		 * @brief Map one id to another
+		 * @brief Map one id to another, indexed by the first id, 0 for none
 		 */
-        typedef std::map<int, int> addressMap;
+        typedef std::vector<int> addressMap;
         /**
 		 * @brief Map an id to a dll::APUpperConvergence, required by the RANG
 		 */
@@ -364,17 +417,10 @@ namespace wifimac { namespace pathselection {
          */
         adr2ucMap portals;
         /**
-         * @brief NxN Matrix of link costs
-         */
-        metricMatrix linkCosts;
-        /**
-         * @brief NxN Matrix of path cost
-         */
-        metricMatrix pathCosts;
-        /**
-         * @brief Next hop matrix of the optimal path
+         * @brief NxN Matrices of link costs, path costs and next hops of the
+         * optimal path
          */
-        addressMatrix paths;
+        AllPairsShortestPath shortestPaths;
         /**
          * @brief Maps client ids to proxies
          */
@@ -400,6 +446,56 @@ namespace wifimac { namespace pathselection {
          */
         bool pathMatrixIsConsistent;
 
+        /**
+         * @brief Repair the path selection matrices after each link change
+         * instead of a full recomputation
+         */
+        const bool incrementalUpdate;
+
+        /**
+         * @brief Compare each incremental update with a full recomputation,
+         * the latter is used in case of deviations
+         */
+        const bool verifyIncrementalUpdate;
+
+        /**
+         * @brief Relative tolerance of the comparison with the full
+         * recomputation
+         */
+        const double verifyTolerance;
+
+        /**
+         * @brief Link changes only invalidate the path selection matrices, the
+         * computation is done once at the end of the current simulation time
+         * or on the next query
+         */
+        const bool deferredUpdate;
+
+        /**
+         * @brief True if onDeferredUpdate is scheduled
+         */
+        bool updateScheduled;
+
+        /**
+         * @brief Flag for each id if it belongs to a MP
+         */
+        std::vector<bool> meshPoints;
+
+        /**
+         * @brief Upper convergence of each portal id, NULL for other ids
+         */
+        std::vector<dll::APUpperConvergence*> portalUCs;
+
+        /**
+         * @brief Cached best portal of each proxy id, see getBestPortalId()
+         */
+        addressMap proxies2portals;
+
+        /**
+         * @brief True if the cached best portal of the proxy id is up to date
+         */
+        std::vector<bool> proxyPortalIsValid;
+
         /**
          * @brief Weight parameter of the given link costs
          */
@@ -0,0 +1,427 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <WIFIMAC/pathselection/tests/AllPairsShortestPathTest.hpp>
+
+using namespace wifimac::pathselection::tests;
+using wifimac::pathselection::AllPairsShortestPath;
+using wifimac::pathselection::Metric;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( AllPairsShortestPathTest );
+
+AllPairsShortestPathTest::AllPairsShortestPathTest():
+    wns::TestFixture(),
+    random()
+{
+}
+
+void AllPairsShortestPathTest::prepare()
+{
+    this->random.reset();
+}
+
+void AllPairsShortestPathTest::cleanup()
+{
+}
+
+Metric AllPairsShortestPathTest::randomCost(int infEvery)
+{
+    if(random(infEvery) == 0)
+    {
+        return Metric();
+    }
+    return Metric(1 + random(10));
+}
+
+void AllPairsShortestPathTest::setBidirectional(AllPairsShortestPath& apsp, int a, int b, const Metric& cost)
+{
+    apsp.setLinkCost(a, b, cost);
+    apsp.setLinkCost(b, a, cost);
+}
+
+void AllPairsShortestPathTest::assertPathsMatch(const AllPairsShortestPath& apsp,
+                                                const AllPairsShortestPath& reference,
+                                                int numNodes)
+{
+    for (int i = 0; i < numNodes; ++i)
+    {
+        for (int j = 0; j < numNodes; ++j)
+        {
+            const Metric cost = apsp.getPathCost(i, j);
+            const Metric expected = reference.getPathCost(i, j);
+            CPPUNIT_ASSERT_EQUAL(expected.isInf(), cost.isInf());
+            if(cost.isInf())
+            {
+                continue;
+            }
+            CPPUNIT_ASSERT_EQUAL(expected.toDouble(), cost.toDouble());
+
+            // the next hops must lead to j over bidirectional links with the
+            // same total cost
+            double sum = 0.0;
+            int numHops = 0;
+            for (int hop = i; hop != j; ++numHops)
+            {
+                CPPUNIT_ASSERT(numHops < numNodes);
+                const int next = apsp.getNextHop(hop, j);
+                CPPUNIT_ASSERT(apsp.getLinkCost(hop, next).isNotInf());
+                CPPUNIT_ASSERT(apsp.getLinkCost(next, hop).isNotInf());
+                sum += apsp.getLinkCost(hop, next).toDouble();
+                hop = next;
+            }
+            CPPUNIT_ASSERT_EQUAL(cost.toDouble(), sum);
+        }
+    }
+}
+
+void AllPairsShortestPathTest::lineTopology()
+{
+    // 0 -1- 1 -2- 2 -3- 3
+    AllPairsShortestPath apsp(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        apsp.addNode(i);
+    }
+    setBidirectional(apsp, 0, 1, Metric(1));
+    setBidirectional(apsp, 1, 2, Metric(2));
+    setBidirectional(apsp, 2, 3, Metric(3));
+    apsp.recompute();
+
+    CPPUNIT_ASSERT_EQUAL(0.0, apsp.getPathCost(2, 2).toDouble());
+    CPPUNIT_ASSERT_EQUAL(6.0, apsp.getPathCost(0, 3).toDouble());
+    CPPUNIT_ASSERT_EQUAL(6.0, apsp.getPathCost(3, 0).toDouble());
+    CPPUNIT_ASSERT_EQUAL(1, apsp.getNextHop(0, 3));
+    CPPUNIT_ASSERT_EQUAL(2, apsp.getNextHop(3, 0));
+    CPPUNIT_ASSERT_EQUAL(2, apsp.getNextHop(1, 3));
+}
+
+void AllPairsShortestPathTest::unidirectionalLink()
+{
+    // node ids need not be dense
+    AllPairsShortestPath apsp(10);
+    apsp.addNode(7);
+    apsp.addNode(3);
+
+    apsp.setLinkCost(7, 3, Metric(1));
+    apsp.update();
+    CPPUNIT_ASSERT(apsp.getLinkCost(7, 3).isNotInf());
+    CPPUNIT_ASSERT(apsp.getPathCost(7, 3).isInf());
+    CPPUNIT_ASSERT(apsp.getPathCost(3, 7).isInf());
+
+    apsp.setLinkCost(3, 7, Metric(2));
+    apsp.update();
+    CPPUNIT_ASSERT_EQUAL(1.0, apsp.getPathCost(7, 3).toDouble());
+    CPPUNIT_ASSERT_EQUAL(2.0, apsp.getPathCost(3, 7).toDouble());
+    CPPUNIT_ASSERT_EQUAL(3, apsp.getNextHop(7, 3));
+}
+
+void AllPairsShortestPathTest::linkFailureReroutes()
+{
+    //   -1- 1 -1-
+    // 0           2
+    //   -2- 3 -2-
+    AllPairsShortestPath apsp(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        apsp.addNode(i);
+    }
+    setBidirectional(apsp, 0, 1, Metric(1));
+    setBidirectional(apsp, 1, 2, Metric(1));
+    setBidirectional(apsp, 0, 3, Metric(2));
+    setBidirectional(apsp, 3, 2, Metric(2));
+    apsp.recompute();
+    CPPUNIT_ASSERT_EQUAL(2.0, apsp.getPathCost(0, 2).toDouble());
+    CPPUNIT_ASSERT_EQUAL(1, apsp.getNextHop(0, 2));
+
+    // closing one direction makes the link unusable in both
+    apsp.setLinkCost(0, 1, Metric());
+    apsp.update();
+    CPPUNIT_ASSERT_EQUAL(4.0, apsp.getPathCost(0, 2).toDouble());
+    CPPUNIT_ASSERT_EQUAL(3, apsp.getNextHop(0, 2));
+    CPPUNIT_ASSERT_EQUAL(5.0, apsp.getPathCost(1, 0).toDouble());
+    CPPUNIT_ASSERT_EQUAL(2, apsp.getNextHop(1, 0));
+    CPPUNIT_ASSERT(apsp.verify(0.0));
+
+    // isolate node 3 completely
+    setBidirectional(apsp, 0, 3, Metric());
+    setBidirectional(apsp, 3, 2, Metric());
+    apsp.update();
+    CPPUNIT_ASSERT(apsp.getPathCost(0, 2).isInf());
+    CPPUNIT_ASSERT(apsp.getPathCost(3, 1).isInf());
+    CPPUNIT_ASSERT_EQUAL(1.0, apsp.getPathCost(1, 2).toDouble());
+    CPPUNIT_ASSERT(apsp.verify(0.0));
+}
+
+void AllPairsShortestPathTest::changedDestinations()
+{
+    // 0 -1- 1 -2- 2 -3- 3, plus 0 -100- 2
+    AllPairsShortestPath apsp(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        apsp.addNode(i);
+    }
+    setBidirectional(apsp, 0, 1, Metric(1));
+    setBidirectional(apsp, 1, 2, Metric(2));
+    setBidirectional(apsp, 2, 3, Metric(3));
+    setBidirectional(apsp, 0, 2, Metric(100));
+    apsp.recompute();
+    apsp.clearChangedPaths();
+
+    // a more expensive link does not change any path
+    setBidirectional(apsp, 0, 2, Metric(50));
+    apsp.update();
+    for (int i = 0; i < 4; ++i)
+    {
+        CPPUNIT_ASSERT(not apsp.pathsChangedTo(i));
+    }
+
+    // the shortcut changes the paths between {0} and {2, 3} only
+    setBidirectional(apsp, 0, 2, Metric(1.5));
+    apsp.update();
+    CPPUNIT_ASSERT(apsp.pathsChangedTo(0));
+    CPPUNIT_ASSERT(not apsp.pathsChangedTo(1));
+    CPPUNIT_ASSERT(apsp.pathsChangedTo(2));
+    CPPUNIT_ASSERT(apsp.pathsChangedTo(3));
+    CPPUNIT_ASSERT_EQUAL(4.5, apsp.getPathCost(0, 3).toDouble());
+
+    apsp.clearChangedPaths();
+    for (int i = 0; i < 4; ++i)
+    {
+        CPPUNIT_ASSERT(not apsp.pathsChangedTo(i));
+    }
+}
+
+void AllPairsShortestPathTest::incrementalDecrease()
+{
+    const int n = 20;
+    AllPairsShortestPath apsp(n);
+    AllPairsShortestPath reference(n);
+    for (int i = 0; i < n; ++i)
+    {
+        apsp.addNode(i);
+        reference.addNode(i);
+    }
+    // sparse start with expensive links
+    for (int i = 0; i < n; ++i)
+    {
+        const int peer = random(n);
+        if(peer != i)
+        {
+            const Metric cost(20 + random(10));
+            setBidirectional(apsp, i, peer, cost);
+            setBidirectional(reference, i, peer, cost);
+        }
+    }
+    apsp.recompute();
+
+    for (int round = 0; round < 200; ++round)
+    {
+        const int a = random(n);
+        const int b = random(n);
+        if(a == b)
+        {
+            continue;
+        }
+        const Metric old = apsp.getLinkCost(a, b);
+        const Metric cost(old.isInf() ? 1 + random(30) : random(static_cast<int>(old.toDouble())) + 1);
+        setBidirectional(apsp, a, b, cost);
+        setBidirectional(reference, a, b, cost);
+
+        apsp.update();
+        reference.recompute();
+        assertPathsMatch(apsp, reference, n);
+    }
+}
+
+void AllPairsShortestPathTest::incrementalIncrease()
+{
+    const int n = 20;
+    AllPairsShortestPath apsp(n);
+    AllPairsShortestPath reference(n);
+    for (int i = 0; i < n; ++i)
+    {
+        apsp.addNode(i);
+        reference.addNode(i);
+    }
+    // dense start with cheap links
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = i + 1; j < n; ++j)
+        {
+            const Metric cost(1 + random(3));
+            setBidirectional(apsp, i, j, cost);
+            setBidirectional(reference, i, j, cost);
+        }
+    }
+    apsp.recompute();
+
+    for (int round = 0; round < 200; ++round)
+    {
+        const int a = random(n);
+        const int b = random(n);
+        if(a == b or apsp.getLinkCost(a, b).isInf())
+        {
+            continue;
+        }
+        // increase or remove the link
+        const Metric old = apsp.getLinkCost(a, b);
+        const Metric cost = (random(4) == 0) ? Metric() : Metric(old.toDouble() + 1 + random(5));
+        setBidirectional(apsp, a, b, cost);
+        setBidirectional(reference, a, b, cost);
+
+        apsp.update();
+        reference.recompute();
+        assertPathsMatch(apsp, reference, n);
+    }
+}
+
+void AllPairsShortestPathTest::incrementalRandomSequence()
+{
+    const int n = 30;
+    AllPairsShortestPath apsp(n);
+    AllPairsShortestPath reference(n);
+    // register in an order different from the ids
+    for (int i = n - 1; i >= 0; --i)
+    {
+        apsp.addNode(i);
+        reference.addNode(i);
+    }
+
+    for (int round = 0; round < 300; ++round)
+    {
+        // batches of unidirectional changes, each of which can also change
+        // the effective weight of the reverse link
+        const int numChanges = 1 + random(n / 2);
+        for (int c = 0; c < numChanges; ++c)
+        {
+            const int a = random(n);
+            const int b = random(n);
+            if(a == b)
+            {
+                continue;
+            }
+            const Metric cost = randomCost(3);
+            apsp.setLinkCost(a, b, cost);
+            reference.setLinkCost(a, b, cost);
+        }
+
+        apsp.update();
+        reference.recompute();
+        assertPathsMatch(apsp, reference, n);
+        CPPUNIT_ASSERT(apsp.verify(0.0));
+    }
+}
+
+void AllPairsShortestPathTest::manyChangesFallBackToRecompute()
+{
+    const int n = 10;
+    AllPairsShortestPath apsp(n);
+    AllPairsShortestPath reference(n);
+    for (int i = 0; i < n; ++i)
+    {
+        apsp.addNode(i);
+        reference.addNode(i);
+    }
+
+    for (int round = 0; round < 20; ++round)
+    {
+        // more changes than nodes
+        for (int c = 0; c < 3 * n; ++c)
+        {
+            const int a = random(n);
+            const int b = random(n);
+            if(a == b)
+            {
+                continue;
+            }
+            const Metric cost = randomCost(4);
+            setBidirectional(apsp, a, b, cost);
+            setBidirectional(reference, a, b, cost);
+        }
+
+        apsp.update();
+        reference.recompute();
+        assertPathsMatch(apsp, reference, n);
+    }
+}
+
+void AllPairsShortestPathTest::threadsGiveIdenticalResults()
+{
+    // large enough to use all threads
+    const int n = 128;
+    AllPairsShortestPath serial(n, 1);
+    AllPairsShortestPath parallel(n, 3);
+    AllPairsShortestPath parallel4(n, 4);
+    for (int i = 0; i < n; ++i)
+    {
+        serial.addNode(i);
+        parallel.addNode(i);
+        parallel4.addNode(i);
+    }
+
+    // the threads are kept between the recomputations
+    for (int round = 0; round < 5; ++round)
+    {
+        for (int c = 0; c < 4 * n; ++c)
+        {
+            const int a = random(n);
+            const int b = random(n);
+            if(a == b)
+            {
+                continue;
+            }
+            // non-integer costs, the results must be bit-identical anyway
+            const Metric cost = (random(5) == 0) ? Metric() : Metric(0.1 + random(1000) / 7.0);
+            setBidirectional(serial, a, b, cost);
+            setBidirectional(parallel, a, b, cost);
+            setBidirectional(parallel4, a, b, cost);
+        }
+
+        serial.recompute();
+        parallel.recompute();
+        parallel4.recompute();
+
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                const Metric expected = serial.getPathCost(i, j);
+                CPPUNIT_ASSERT_EQUAL(expected.isInf(), parallel.getPathCost(i, j).isInf());
+                CPPUNIT_ASSERT_EQUAL(expected.isInf(), parallel4.getPathCost(i, j).isInf());
+                if(expected.isInf())
+                {
+                    continue;
+                }
+                CPPUNIT_ASSERT_EQUAL(expected.toDouble(), parallel.getPathCost(i, j).toDouble());
+                CPPUNIT_ASSERT_EQUAL(expected.toDouble(), parallel4.getPathCost(i, j).toDouble());
+                CPPUNIT_ASSERT_EQUAL(serial.getNextHop(i, j), parallel.getNextHop(i, j));
+                CPPUNIT_ASSERT_EQUAL(serial.getNextHop(i, j), parallel4.getNextHop(i, j));
+            }
+        }
+    }
+}
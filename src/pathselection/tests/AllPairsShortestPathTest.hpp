@@ -0,0 +1,106 @@
+/******************************************************************************
+ * WiFiMac                                                                    *
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2007
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 16, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef WIFIMAC_PATHSELECTION_TESTS_ALLPAIRSSHORTESTPATHTEST_HPP
+#define WIFIMAC_PATHSELECTION_TESTS_ALLPAIRSSHORTESTPATHTEST_HPP
+
+#include <WIFIMAC/pathselection/AllPairsShortestPath.hpp>
+
+#include <WIFIMAC/helper/tests/Random.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+namespace wifimac { namespace pathselection { namespace tests {
+
+    class AllPairsShortestPathTest:
+        public wns::TestFixture
+    {
+        CPPUNIT_TEST_SUITE( AllPairsShortestPathTest );
+        CPPUNIT_TEST( lineTopology );
+        CPPUNIT_TEST( unidirectionalLink );
+        CPPUNIT_TEST( linkFailureReroutes );
+        CPPUNIT_TEST( changedDestinations );
+        CPPUNIT_TEST( incrementalDecrease );
+        CPPUNIT_TEST( incrementalIncrease );
+        CPPUNIT_TEST( incrementalRandomSequence );
+        CPPUNIT_TEST( manyChangesFallBackToRecompute );
+        CPPUNIT_TEST( threadsGiveIdenticalResults );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        AllPairsShortestPathTest();
+
+    private:
+        virtual void prepare();
+        virtual void cleanup();
+
+        // the tests
+        void lineTopology();
+        void unidirectionalLink();
+        void linkFailureReroutes();
+        void changedDestinations();
+        void incrementalDecrease();
+        void incrementalIncrease();
+        void incrementalRandomSequence();
+        void manyChangesFallBackToRecompute();
+        void threadsGiveIdenticalResults();
+
+        // support functions
+
+        /**
+         * @brief Random link cost, inf with probability 1/infEvery
+         *
+         * The finite costs are integers, so that all path costs are exact and
+         * can be compared without tolerance.
+         */
+        Metric
+        randomCost(int infEvery);
+
+        /**
+         * @brief Set the same link cost in both directions
+         */
+        static void
+        setBidirectional(AllPairsShortestPath& apsp, int a, int b, const Metric& cost);
+
+        /**
+         * @brief Checks that the path costs of both engines are equal and that
+         * the next hops of apsp lead along links of the given path cost
+         */
+        static void
+        assertPathsMatch(const AllPairsShortestPath& apsp,
+                         const AllPairsShortestPath& reference,
+                         int numNodes);
+
+        wifimac::helper::tests::Random random;
+    };
+
+} // tests
+} // pathselection
+} // wifimac
+
+#endif // WIFIMAC_PATHSELECTION_TESTS_ALLPAIRSSHORTESTPATHTEST_HPP